@@ -0,0 +1,336 @@
+/*
+ * bench.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "bench.h"
+
+#include "debug.h"
+#include "rt_sem.h"
+
+#define BENCH_OUTPUT_SIZE   (4096)
+#define BENCH_UART          USART1
+#define BENCH_UART_BAUD     (115200)
+
+static void bench_clock_config(void);
+static void bench_uart_init(void);
+static void bench_timer_init(void);
+static void bench_calibrate(void);
+static void bench_exit(void);
+
+static void bench_putc(const char c);
+static void bench_puts(const char *s);
+static void bench_putu(uint32_t u);
+static void bench_put_field(const char *name, const uint32_t value);
+
+DEFINE_TASK(bench_runner_fcn, bench_runner, "BENCH", 1, BENCH_TASK_STACK_SIZE);
+
+volatile uint32_t bench_t0;
+
+// Also readable with a debugger when no uart is connected
+char bench_output[BENCH_OUTPUT_SIZE];
+static uint32_t bench_output_len = 0;
+
+static UART_HandleTypeDef bench_uart;
+
+static rt_sem_t sem_never;
+
+static const char *bench_name;
+static uint32_t bench_overhead = 0;
+static uint32_t bench_first_result;
+static volatile uint32_t n_samples;
+static uint32_t sample[BENCH_SAMPLES];
+static uint32_t min, max, sum;  // No libgcc for 64 bit division
+
+int main(void)
+{
+  HAL_Init();
+
+  bench_clock_config();
+
+  debug_init();
+  bench_uart_init();
+  bench_timer_init();
+
+  rt_init();
+
+  rt_sem_init(&sem_never, 0);
+
+  rt_create_task(&bench_runner, NULL);
+  bench_micro_init();
+  bench_macro_init();
+
+  HAL_InitTick(TICK_INT_PRIORITY);
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  rt_start();
+
+  while(1);
+
+  return 0;
+}
+
+void bench_runner_fcn(void *p)
+{
+  bench_calibrate();
+
+  bench_micro_run();
+  bench_macro_run();
+
+  bench_exit();
+}
+
+void bench_suite_begin(const char *suite)
+{
+  bench_puts("{\"suite\":\"");
+  bench_puts(suite);
+#ifdef RT_BENCH_QEMU
+  bench_puts("\",\"target\":\"qemu-netduinoplus2\",");
+  bench_put_field("clock_hz", HAL_RCC_GetPCLK1Freq());
+#else
+  bench_puts("\",\"target\":\"stm32f4\",");
+  bench_put_field("clock_hz", SystemCoreClock);
+#endif
+  bench_puts(",\"unit\":\"" BENCH_UNIT "\",");
+  bench_put_field("tick_hz", 1000);
+  bench_puts(",\"results\":[");
+
+  bench_first_result = 1;
+}
+
+void bench_suite_end(void)
+{
+  bench_puts("]}\n");
+}
+
+void bench_start(const char *name)
+{
+  bench_name = name;
+  n_samples = 0;
+  min = 0xFFFFFFFF;
+  max = 0;
+  sum = 0;
+}
+
+void bench_sample(const uint32_t cycles)
+{
+  uint32_t value = (cycles > bench_overhead) ? cycles - bench_overhead : 0;
+
+  if (n_samples >= BENCH_SAMPLES)
+    return;
+
+  sample[n_samples++] = value;
+  sum += value;
+
+  if (value < min)
+    min = value;
+  if (value > max)
+    max = value;
+}
+
+uint32_t bench_samples(void)
+{
+  return n_samples;
+}
+
+void bench_stop(void)
+{
+  uint32_t i, j, value, n = n_samples;
+
+  // Insertion sort, n is small
+  for (i = 1; i < n; i++) {
+    value = sample[i];
+    for (j = i; j > 0 && sample[j-1] > value; j--)
+      sample[j] = sample[j-1];
+    sample[j] = value;
+  }
+
+  if (!bench_first_result)
+    bench_putc(',');
+  bench_first_result = 0;
+
+  bench_puts("{\"name\":\"");
+  bench_puts(bench_name);
+  bench_puts("\",");
+  bench_put_field("n", n);
+
+  if (n > 0) {
+    bench_putc(',');
+    bench_put_field("min", min);
+    bench_putc(',');
+    bench_put_field("mean", sum / n);
+    bench_putc(',');
+    bench_put_field("max", max);
+    bench_putc(',');
+    bench_put_field("p50", sample[(n * 50) / 100]);
+    bench_putc(',');
+    bench_put_field("p90", sample[(n * 90) / 100]);
+    bench_putc(',');
+    bench_put_field("p99", sample[(n * 99) / 100]);
+  }
+
+  bench_putc('}');
+}
+
+void bench_report_count(const char *name, const uint32_t count, const uint32_t window_ms)
+{
+  if (!bench_first_result)
+    bench_putc(',');
+  bench_first_result = 0;
+
+  bench_puts("{\"name\":\"");
+  bench_puts(name);
+  bench_puts("\",");
+  bench_put_field("count", count);
+  bench_putc(',');
+  bench_put_field("window_ms", window_ms);
+  bench_putc('}');
+}
+
+void bench_sleep(const uint32_t ticks)
+{
+  // There is no plain delay in the kernel, so time out on a semaphore
+  // that is never given
+  rt_sem_take(&sem_never, ticks);
+}
+
+static void bench_calibrate(void)
+{
+  // Cost of reading the cycle counter twice, subtracted from every sample
+  uint32_t i, t0, t1, least = 0xFFFFFFFF;
+
+  for (i = 0; i < 32; i++) {
+    t0 = bench_cycles();
+    t1 = bench_cycles();
+    if (t1 - t0 < least)
+      least = t1 - t0;
+  }
+
+  bench_overhead = least;
+}
+
+static void bench_exit(void)
+{
+#ifdef RT_BENCH_QEMU
+  // Semihosting SYS_EXIT with ADP_Stopped_ApplicationExit, needs -semihosting
+  __asm volatile (
+    " mov r0, #0x18             \n\t"
+    " ldr r1, =0x20026          \n\t"
+    " bkpt 0xAB                 \n\t"
+    :
+    :
+    : "r0", "r1"
+  );
+#endif
+
+  while (1) {
+    DBG_LED_TOGGLE;
+    rt_periodic_delay(500);
+  }
+}
+
+static void bench_putc(const char c)
+{
+  if (bench_output_len < BENCH_OUTPUT_SIZE-1)
+    bench_output[bench_output_len++] = c;
+
+  while ((BENCH_UART->SR & USART_SR_TXE) == 0);
+  BENCH_UART->DR = c;
+}
+
+static void bench_puts(const char *s)
+{
+  while (*s)
+    bench_putc(*s++);
+}
+
+static void bench_putu(uint32_t u)
+{
+  char digits[10];
+  uint32_t n = 0;
+
+  do {
+    digits[n++] = '0' + u % 10;
+    u /= 10;
+  } while (u > 0);
+
+  while (n > 0)
+    bench_putc(digits[--n]);
+}
+
+static void bench_put_field(const char *name, const uint32_t value)
+{
+  bench_putc('"');
+  bench_puts(name);
+  bench_puts("\":");
+  bench_putu(value);
+}
+
+static void bench_uart_init(void)
+{
+  GPIO_InitTypeDef GPIOinitstruct;
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_USART1_CLK_ENABLE();
+
+  // PA9: USART1 TX
+  GPIOinitstruct.Pin = GPIO_PIN_9;
+  GPIOinitstruct.Mode = GPIO_MODE_AF_PP;
+  GPIOinitstruct.Pull = GPIO_PULLUP;
+  GPIOinitstruct.Speed = GPIO_SPEED_HIGH;
+  GPIOinitstruct.Alternate = GPIO_AF7_USART1;
+  HAL_GPIO_Init(GPIOA, &GPIOinitstruct);
+
+  bench_uart.Instance = BENCH_UART;
+  bench_uart.Init.BaudRate = BENCH_UART_BAUD;
+  bench_uart.Init.WordLength = UART_WORDLENGTH_8B;
+  bench_uart.Init.StopBits = UART_STOPBITS_1;
+  bench_uart.Init.Parity = UART_PARITY_NONE;
+  bench_uart.Init.Mode = UART_MODE_TX;
+  bench_uart.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+  bench_uart.Init.OverSampling = UART_OVERSAMPLING_16;
+  HAL_UART_Init(&bench_uart);
+}
+
+static void bench_timer_init(void)
+{
+#ifdef RT_BENCH_QEMU
+  __TIM2_CLK_ENABLE();
+
+  BENCH_TIM->PSC = 0;
+  BENCH_TIM->ARR = 0xFFFFFFFF;
+  BENCH_TIM->EGR = TIM_EGR_UG;
+  BENCH_TIM->CR1 = TIM_CR1_CEN;
+#endif
+}
+
+static void bench_clock_config(void)
+{
+#ifndef RT_BENCH_QEMU
+  // Same as the application: 168 MHz from PLL (HSE)
+  RCC_ClkInitTypeDef RCC_ClkInitStruct;
+  RCC_OscInitTypeDef RCC_OscInitStruct;
+
+  __HAL_RCC_PWR_CLK_ENABLE();
+  __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
+
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+  RCC_OscInitStruct.HSEState = RCC_HSE_ON;
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+  RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+  RCC_OscInitStruct.PLL.PLLM = 16;
+  RCC_OscInitStruct.PLL.PLLN = 336;
+  RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV2;
+  RCC_OscInitStruct.PLL.PLLQ = 7;
+  HAL_RCC_OscConfig(&RCC_OscInitStruct);
+
+  RCC_ClkInitStruct.ClockType = (RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2);
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV4;
+  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV2;
+  HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_5);
+#endif
+  // qemu does not model the RCC, keep running on the reset clock
+}
@@ -0,0 +1,60 @@
+/*
+ * bench.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+#include "rt_kernel.h"
+
+// Kernel benchmark firmware, built with "make bench" (add BENCH_QEMU=1 to
+// run it on qemu-system-arm -M netduinoplus2). Results are written as one
+// JSON document per suite and line on USART1, and to bench_output in RAM.
+
+#define BENCH_SAMPLES           (128)
+#define BENCH_TIMEOUT           (0x7FFFFFFF)  // Ticks, long enough to be forever
+#define BENCH_TASK_STACK_SIZE   (256)
+#define BENCH_MACRO_WINDOW_MS   (2000)
+
+#ifdef RT_BENCH_QEMU
+// No DWT in qemu, use a free running 32 bit timer instead
+#define BENCH_TIM               TIM2
+#define BENCH_UNIT              "ticks"
+#else
+#define BENCH_UNIT              "cycles"
+#endif
+
+ALWAYS_INLINE static uint32_t bench_cycles(void)
+{
+#ifdef RT_BENCH_QEMU
+  return BENCH_TIM->CNT;
+#else
+  return rt_get_cycles();
+#endif
+}
+
+extern volatile uint32_t bench_t0;
+
+void bench_suite_begin(const char *suite);
+void bench_suite_end(void);
+
+void bench_start(const char *name);
+void bench_sample(const uint32_t cycles);
+uint32_t bench_samples(void);
+void bench_stop(void);
+
+void bench_report_count(const char *name, const uint32_t count, const uint32_t window_ms);
+void bench_sleep(const uint32_t ticks);
+
+void bench_micro_init(void);
+void bench_micro_run(void);
+
+void bench_macro_init(void);
+void bench_macro_run(void);
+
+#endif /* BENCH_H_ */
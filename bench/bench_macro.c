@@ -0,0 +1,280 @@
+/*
+ * bench_macro.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "bench.h"
+
+#include "rt_sem.h"
+#include "rt_queue.h"
+
+// Thread-Metric style throughput tests. Each test runs for
+// BENCH_MACRO_WINDOW_MS and reports the number of completed operations.
+// The controller runs at the highest prio and sleeps during the window,
+// the workers park on semaphores when their test is not running.
+//
+// Differences from Thread-Metric: there are only RT_PRIO_LEVELS-1 task
+// prios, so preemptive scheduling uses a chain of three tasks instead of
+// five. The kernel has no memory pool, so memory allocation uses a queue
+// of free block pointers as a fixed block pool.
+
+#define MACRO_IRQn          EXTI1_IRQn
+#define MACRO_IRQHandler    EXTI1_IRQHandler
+#define MACRO_IRQ_PRIO      (10)
+
+#define MACRO_COOP_TASKS    (5)
+#define MACRO_CHAIN_TASKS   (3)
+#define MACRO_MSG_WORDS     (4)
+#define MACRO_POOL_BLOCKS   (8)
+#define MACRO_BLOCK_WORDS   (32)
+
+enum {
+  MACRO_NONE = 0,
+  MACRO_COOPERATIVE,
+  MACRO_PREEMPTIVE,
+  MACRO_INTERRUPT,
+  MACRO_INTERRUPT_PREEMPTION,
+  MACRO_MESSAGE,
+  MACRO_SYNC,
+  MACRO_MEMORY
+};
+
+DEFINE_TASK(macro_ctrl_fcn, macro_ctrl, "MCTRL", 3, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(coop_fcn, coop_0, "COOP0", 2, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(coop_fcn, coop_1, "COOP1", 2, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(coop_fcn, coop_2, "COOP2", 2, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(coop_fcn, coop_3, "COOP3", 2, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(coop_fcn, coop_4, "COOP4", 2, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(chain_fcn, chain_0, "CHAIN0", 1, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(chain_fcn, chain_1, "CHAIN1", 2, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(chain_fcn, chain_2, "CHAIN2", 3, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(worker_fcn, worker, "WORKER", 2, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(irq_high_fcn, irq_high, "IRQHI", 3, BENCH_TASK_STACK_SIZE);
+
+static rt_sem_t sem_macro_start, sem_macro_done;
+static rt_sem_t sem_coop_start, sem_chain_start, sem_worker_start;
+static rt_sem_t sem_chain[MACRO_CHAIN_TASKS];
+static rt_sem_t sem_irq, sem_irq_high, sem_sync;
+
+static rt_queue_t queue_msg, queue_pool;
+static uint32_t queue_msg_buffer[MACRO_MSG_WORDS];
+static uint32_t *queue_pool_buffer[MACRO_POOL_BLOCKS];
+static uint32_t pool_block[MACRO_POOL_BLOCKS][MACRO_BLOCK_WORDS];
+
+static volatile uint32_t macro_test = MACRO_NONE;
+static volatile uint32_t counter[MACRO_COOP_TASKS];
+
+static void macro_run_test(const char *name, const uint32_t test);
+
+void bench_macro_init(void)
+{
+  uint32_t i;
+  uint32_t *block;
+
+  rt_sem_init(&sem_macro_start, 0);
+  rt_sem_init(&sem_macro_done, 0);
+  rt_sem_init(&sem_coop_start, 0);
+  rt_sem_init(&sem_chain_start, 0);
+  rt_sem_init(&sem_worker_start, 0);
+  rt_sem_init(&sem_irq, 0);
+  rt_sem_init(&sem_irq_high, 0);
+  rt_sem_init(&sem_sync, 0);
+
+  for (i = 0; i < MACRO_CHAIN_TASKS; i++)
+    rt_sem_init(&sem_chain[i], 0);
+
+  rt_queue_init(&queue_msg, (uint8_t *) queue_msg_buffer, sizeof(queue_msg_buffer), 1);
+  rt_queue_init(&queue_pool, (uint8_t *) queue_pool_buffer, sizeof(uint32_t *), MACRO_POOL_BLOCKS);
+
+  for (i = 0; i < MACRO_POOL_BLOCKS; i++) {
+    block = pool_block[i];
+    rt_queue_push_from_isr(&queue_pool, &block);
+  }
+
+  rt_create_task(&macro_ctrl, NULL);
+  rt_create_task(&coop_0, (void *) 0);
+  rt_create_task(&coop_1, (void *) 1);
+  rt_create_task(&coop_2, (void *) 2);
+  rt_create_task(&coop_3, (void *) 3);
+  rt_create_task(&coop_4, (void *) 4);
+  rt_create_task(&chain_0, (void *) 0);
+  rt_create_task(&chain_1, (void *) 1);
+  rt_create_task(&chain_2, (void *) 2);
+  rt_create_task(&worker, NULL);
+  rt_create_task(&irq_high, NULL);
+
+  HAL_NVIC_SetPriority(MACRO_IRQn, MACRO_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(MACRO_IRQn);
+}
+
+void bench_macro_run(void)
+{
+  rt_sem_give(&sem_macro_start);
+  rt_sem_take(&sem_macro_done, BENCH_TIMEOUT);
+}
+
+void macro_ctrl_fcn(void *p)
+{
+  while (1) {
+    if (rt_sem_take(&sem_macro_start, BENCH_TIMEOUT) != RT_OK)
+      continue;
+
+    bench_suite_begin("macro");
+
+    macro_run_test("cooperative_scheduling", MACRO_COOPERATIVE);
+    macro_run_test("preemptive_scheduling", MACRO_PREEMPTIVE);
+    macro_run_test("interrupt_processing", MACRO_INTERRUPT);
+    macro_run_test("interrupt_preemption_processing", MACRO_INTERRUPT_PREEMPTION);
+    macro_run_test("message_processing", MACRO_MESSAGE);
+    macro_run_test("synchronization_processing", MACRO_SYNC);
+    macro_run_test("memory_allocation", MACRO_MEMORY);
+
+    bench_suite_end();
+
+    rt_sem_give(&sem_macro_done);
+  }
+}
+
+static void macro_run_test(const char *name, const uint32_t test)
+{
+  uint32_t i, count = 0;
+
+  for (i = 0; i < MACRO_COOP_TASKS; i++)
+    counter[i] = 0;
+
+  macro_test = test;
+
+  if (test == MACRO_COOPERATIVE) {
+    for (i = 0; i < MACRO_COOP_TASKS; i++)
+      rt_sem_give(&sem_coop_start);
+  } else if (test == MACRO_PREEMPTIVE) {
+    rt_sem_give(&sem_chain_start);
+  } else {
+    rt_sem_give(&sem_worker_start);
+  }
+
+  bench_sleep(BENCH_MACRO_WINDOW_MS);
+
+  for (i = 0; i < MACRO_COOP_TASKS; i++)
+    count += counter[i];
+
+  // Let the workers park before the next test
+  macro_test = MACRO_NONE;
+  bench_sleep(2);
+
+  bench_report_count(name, count, BENCH_MACRO_WINDOW_MS);
+}
+
+void coop_fcn(void *p)
+{
+  uint32_t index = (uint32_t) p;
+
+  while (1) {
+    if (rt_sem_take(&sem_coop_start, BENCH_TIMEOUT) != RT_OK)
+      continue;
+
+    while (macro_test == MACRO_COOPERATIVE) {
+      counter[index]++;
+      rt_yield();
+    }
+  }
+}
+
+void chain_fcn(void *p)
+{
+  uint32_t index = (uint32_t) p;
+
+  // The lowest prio task resumes the next, which resumes the next...
+  // and they all run to completion in reverse order
+  while (1) {
+    if (index == 0) {
+      if (rt_sem_take(&sem_chain_start, BENCH_TIMEOUT) != RT_OK)
+        continue;
+
+      while (macro_test == MACRO_PREEMPTIVE) {
+        rt_sem_give(&sem_chain[1]);
+        counter[0]++;
+      }
+    } else if (rt_sem_take(&sem_chain[index], BENCH_TIMEOUT) == RT_OK) {
+      if (index < MACRO_CHAIN_TASKS-1)
+        rt_sem_give(&sem_chain[index+1]);
+      counter[index]++;
+    }
+  }
+}
+
+void worker_fcn(void *p)
+{
+  uint32_t msg_out[MACRO_MSG_WORDS] = {1, 2, 3, 4};
+  uint32_t msg_in[MACRO_MSG_WORDS];
+  uint32_t *block;
+
+  while (1) {
+    if (rt_sem_take(&sem_worker_start, BENCH_TIMEOUT) != RT_OK)
+      continue;
+
+    switch (macro_test) {
+      case MACRO_INTERRUPT:
+        // The ISR gives the semaphore, so it is never blocking
+        while (macro_test == MACRO_INTERRUPT) {
+          NVIC_SetPendingIRQ(MACRO_IRQn);
+          if (rt_sem_take(&sem_irq, BENCH_TIMEOUT) == RT_OK)
+            counter[0]++;
+        }
+        break;
+
+      case MACRO_INTERRUPT_PREEMPTION:
+        // The ISR wakes irq_high which preempts this task, it counts
+        while (macro_test == MACRO_INTERRUPT_PREEMPTION)
+          NVIC_SetPendingIRQ(MACRO_IRQn);
+        break;
+
+      case MACRO_MESSAGE:
+        while (macro_test == MACRO_MESSAGE) {
+          rt_queue_push(&queue_msg, msg_out, BENCH_TIMEOUT);
+          if (rt_queue_pull(&queue_msg, msg_in, BENCH_TIMEOUT) == RT_OK)
+            counter[0]++;
+        }
+        break;
+
+      case MACRO_SYNC:
+        while (macro_test == MACRO_SYNC) {
+          rt_sem_give(&sem_sync);
+          if (rt_sem_take(&sem_sync, BENCH_TIMEOUT) == RT_OK)
+            counter[0]++;
+        }
+        break;
+
+      case MACRO_MEMORY:
+        while (macro_test == MACRO_MEMORY) {
+          if (rt_queue_pull(&queue_pool, &block, BENCH_TIMEOUT) == RT_OK) {
+            block[0] = counter[0];
+            rt_queue_push(&queue_pool, &block, BENCH_TIMEOUT);
+            counter[0]++;
+          }
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+void irq_high_fcn(void *p)
+{
+  while (1) {
+    if (rt_sem_take(&sem_irq_high, BENCH_TIMEOUT) == RT_OK)
+      counter[1]++;
+  }
+}
+
+void MACRO_IRQHandler(void)
+{
+  rt_sem_t *sem = (macro_test == MACRO_INTERRUPT_PREEMPTION) ? &sem_irq_high : &sem_irq;
+
+  if (rt_sem_give_from_isr(sem) != RT_NOK)
+    rt_pend_yield();
+}
@@ -0,0 +1,292 @@
+/*
+ * bench_micro.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "bench.h"
+
+#include "rt_sem.h"
+#include "rt_queue.h"
+
+// The runner (bench_runner, prio 1) drives every benchmark. Contended
+// cases use a helper at prio 3 that is blocked on the object and samples
+// the time from bench_t0, set by the runner, to when it is running again.
+
+#define BENCH_IRQn          EXTI0_IRQn
+#define BENCH_IRQHandler    EXTI0_IRQHandler
+#define BENCH_IRQ_PRIO      (10)
+
+DEFINE_TASK(sem_waiter_fcn, sem_waiter, "SEMW", 3, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(isr_waiter_fcn, isr_waiter, "ISRW", 3, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(queue_puller_fcn, queue_puller, "QPULL", 3, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(queue_pusher_fcn, queue_pusher, "QPUSH", 3, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(delayer_fcn, delayer, "DELAY", 3, BENCH_TASK_STACK_SIZE);
+DEFINE_TASK(yield_partner_fcn, yield_partner, "YIELD", 1, BENCH_TASK_STACK_SIZE);
+
+static rt_sem_t sem, sem_wake, sem_isr, sem_delay_start, sem_yield_start;
+
+static rt_queue_t queue, queue_wake, queue_full;
+static uint32_t queue_buffer[BENCH_SAMPLES];
+static uint32_t queue_wake_buffer[1];
+static uint32_t queue_full_buffer[1];
+
+static volatile uint32_t pusher_armed = 0;
+static volatile uint32_t delay_active = 0;
+static volatile uint32_t delay_seq = 0;
+static volatile uint32_t yield_active = 0;
+static volatile uint32_t yield_fpu = 0;
+static volatile float fpu_dummy = 1.0f;
+
+static void bench_sem(void);
+static void bench_queue(void);
+static void bench_isr(void);
+static void bench_periodic_delay(void);
+static void bench_yield(const uint32_t use_fpu);
+
+void bench_micro_init(void)
+{
+  rt_sem_init(&sem, 0);
+  rt_sem_init(&sem_wake, 0);
+  rt_sem_init(&sem_isr, 0);
+  rt_sem_init(&sem_delay_start, 0);
+  rt_sem_init(&sem_yield_start, 0);
+
+  rt_queue_init(&queue, (uint8_t *) queue_buffer, sizeof(uint32_t), BENCH_SAMPLES);
+  rt_queue_init(&queue_wake, (uint8_t *) queue_wake_buffer, sizeof(uint32_t), 1);
+  rt_queue_init(&queue_full, (uint8_t *) queue_full_buffer, sizeof(uint32_t), 1);
+
+  rt_create_task(&sem_waiter, NULL);
+  rt_create_task(&isr_waiter, NULL);
+  rt_create_task(&queue_puller, NULL);
+  rt_create_task(&queue_pusher, NULL);
+  rt_create_task(&delayer, NULL);
+  rt_create_task(&yield_partner, NULL);
+
+  HAL_NVIC_SetPriority(BENCH_IRQn, BENCH_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(BENCH_IRQn);
+}
+
+void bench_micro_run(void)
+{
+  bench_suite_begin("micro");
+
+  bench_sem();
+  bench_queue();
+  bench_isr();
+  bench_periodic_delay();
+  bench_yield(0);
+  bench_yield(1);
+
+  bench_suite_end();
+}
+
+static void bench_sem(void)
+{
+  uint32_t i, t0;
+
+  bench_start("sem_give");
+  for (i = 0; i < BENCH_SAMPLES; i++) {
+    t0 = bench_cycles();
+    rt_sem_give(&sem);
+    bench_sample(bench_cycles() - t0);
+  }
+  bench_stop();
+
+  bench_start("sem_take");
+  for (i = 0; i < BENCH_SAMPLES; i++) {
+    t0 = bench_cycles();
+    rt_sem_take(&sem, BENCH_TIMEOUT);
+    bench_sample(bench_cycles() - t0);
+  }
+  bench_stop();
+
+  // Give to a blocked higher prio task, until it returns from rt_sem_take
+  bench_start("sem_give_wake");
+  for (i = 0; i < BENCH_SAMPLES; i++) {
+    bench_t0 = bench_cycles();
+    rt_sem_give(&sem_wake);
+  }
+  bench_stop();
+}
+
+static void bench_queue(void)
+{
+  uint32_t i, t0, item = 0;
+
+  bench_start("queue_push");
+  for (i = 0; i < BENCH_SAMPLES; i++) {
+    t0 = bench_cycles();
+    rt_queue_push(&queue, &item, BENCH_TIMEOUT);
+    bench_sample(bench_cycles() - t0);
+  }
+  bench_stop();
+
+  bench_start("queue_pull");
+  for (i = 0; i < BENCH_SAMPLES; i++) {
+    t0 = bench_cycles();
+    rt_queue_pull(&queue, &item, BENCH_TIMEOUT);
+    bench_sample(bench_cycles() - t0);
+  }
+  bench_stop();
+
+  // Push to a higher prio task blocked on an empty queue
+  bench_start("queue_push_wake");
+  for (i = 0; i < BENCH_SAMPLES; i++) {
+    bench_t0 = bench_cycles();
+    rt_queue_push(&queue_wake, &item, BENCH_TIMEOUT);
+  }
+  bench_stop();
+
+  // Pull from a full queue with a higher prio task blocked on push
+  bench_start("queue_pull_wake");
+  for (i = 0; i < BENCH_SAMPLES; i++) {
+    pusher_armed = 1;
+    bench_t0 = bench_cycles();
+    rt_queue_pull(&queue_full, &item, BENCH_TIMEOUT);
+  }
+  bench_stop();
+}
+
+static void bench_isr(void)
+{
+  uint32_t i;
+
+  // From pending the interrupt until the task blocked on the semaphore
+  // given by the ISR is running
+  bench_start("isr_to_task_wake");
+  for (i = 0; i < BENCH_SAMPLES; i++) {
+    bench_t0 = bench_cycles();
+    NVIC_SetPendingIRQ(BENCH_IRQn);
+  }
+  bench_stop();
+}
+
+static void bench_periodic_delay(void)
+{
+  uint32_t seq;
+
+  // From rt_periodic_delay in a higher prio task until the runner is running
+  bench_start("periodic_delay_switch");
+  delay_active = 1;
+  seq = delay_seq;
+  rt_sem_give(&sem_delay_start);
+
+  while (bench_samples() < BENCH_SAMPLES) {
+    if (delay_seq != seq) {
+      bench_sample(bench_cycles() - bench_t0);
+      seq = delay_seq;
+    }
+  }
+
+  delay_active = 0;
+  bench_stop();
+}
+
+static void bench_yield(const uint32_t use_fpu)
+{
+  // rt_yield to another task of the same prio, until it is running
+  bench_start(use_fpu ? "yield_switch_fpu" : "yield_switch");
+  yield_fpu = use_fpu;
+  yield_active = 1;
+  rt_sem_give(&sem_yield_start);
+
+  while (bench_samples() < BENCH_SAMPLES) {
+    if (yield_fpu)
+      fpu_dummy *= 1.0001f;
+
+    bench_t0 = bench_cycles();
+    rt_yield();
+    bench_sample(bench_cycles() - bench_t0);
+  }
+
+  // Let the partner see that it is done
+  yield_active = 0;
+  rt_yield();
+
+  bench_stop();
+}
+
+void BENCH_IRQHandler(void)
+{
+  if (rt_sem_give_from_isr(&sem_isr) != RT_NOK)
+    rt_pend_yield();
+}
+
+void sem_waiter_fcn(void *p)
+{
+  while (1) {
+    if (rt_sem_take(&sem_wake, BENCH_TIMEOUT) == RT_OK)
+      bench_sample(bench_cycles() - bench_t0);
+  }
+}
+
+void isr_waiter_fcn(void *p)
+{
+  while (1) {
+    if (rt_sem_take(&sem_isr, BENCH_TIMEOUT) == RT_OK)
+      bench_sample(bench_cycles() - bench_t0);
+  }
+}
+
+void queue_puller_fcn(void *p)
+{
+  uint32_t item;
+
+  while (1) {
+    if (rt_queue_pull(&queue_wake, &item, BENCH_TIMEOUT) == RT_OK)
+      bench_sample(bench_cycles() - bench_t0);
+  }
+}
+
+void queue_pusher_fcn(void *p)
+{
+  uint32_t item = 0;
+
+  while (1) {
+    // Fills the queue on the first pass, then blocks until the runner pulls
+    if (rt_queue_push(&queue_full, &item, BENCH_TIMEOUT) == RT_OK && pusher_armed) {
+      bench_sample(bench_cycles() - bench_t0);
+      pusher_armed = 0;
+    }
+  }
+}
+
+void delayer_fcn(void *p)
+{
+  while (1) {
+    rt_sem_take(&sem_delay_start, BENCH_TIMEOUT);
+
+    // rt_periodic_delay counts from when the task was last woken by the
+    // tick, so let it time out once to get a fresh reference
+    bench_sleep(1);
+
+    while (delay_active) {
+      bench_t0 = bench_cycles();
+      delay_seq++;
+      rt_periodic_delay(1);
+    }
+  }
+}
+
+void yield_partner_fcn(void *p)
+{
+  while (1) {
+    rt_sem_take(&sem_yield_start, BENCH_TIMEOUT);
+
+    // Hand back to the runner without a sample, bench_t0 is stale
+    bench_t0 = bench_cycles();
+    rt_yield();
+
+    while (yield_active) {
+      bench_sample(bench_cycles() - bench_t0);
+
+      if (yield_fpu)
+        fpu_dummy *= 1.0001f;
+
+      bench_t0 = bench_cycles();
+      rt_yield();
+    }
+  }
+}
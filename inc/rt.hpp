@@ -0,0 +1,312 @@
+/*
+ * rt.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_HPP_
+#define RT_HPP_
+
+#include <cstdint>
+#include <type_traits>
+
+extern "C" {
+#include "rt_kernel.h"
+#include "rt_sem.h"
+#include "rt_queue.h"
+#include "rt_msgbuf.h"
+#include "rt_prio_queue.h"
+#include "rt_mailbox.h"
+#include "rt_shared.h"
+}
+
+// Header only C++ wrappers of the kernel objects, with the storage sized
+// and aligned at compile time:
+//
+//   rt::Task<256, 2> control_task(control_fcn, "CONTROL");
+//   rt::Queue<sample_t, 16> samples;
+//   rt::Semaphore<1> adc_done;
+//
+//   control_task.start();
+//   samples.push(sample);
+//   {
+//     rt::Lock lock(adc_done);    // take, and give when out of scope
+//     ...
+//   }
+//
+// Everything is inline and calls the C API directly, so there is no
+// overhead compared to it. Queue items are copied as whole words when
+// the size allows, see rt_queue.c. Needs C++17.
+
+namespace rt {
+
+// Default timeout. RT_FOREVER_TICK can not be used as one, the wake up
+// tick would wrap around to before the current tick and not block at all.
+constexpr uint32_t forever = 0x7FFFFFFF;
+
+class CriticalSection {
+  // rt_enter_critical for the lifetime of the object
+public:
+  CriticalSection() { rt_enter_critical(); }
+  ~CriticalSection() { rt_exit_critical(); }
+
+  CriticalSection(const CriticalSection &) = delete;
+  CriticalSection &operator=(const CriticalSection &) = delete;
+};
+
+template <uint32_t Max = UINT32_MAX>
+class Semaphore {
+  // Max = 1 gives a binary semaphore, gives above Max are ignored
+public:
+  explicit Semaphore(const uint32_t count = 0) { rt_sem_init(&sem, (count < Max) ? count : Max); }
+
+  Semaphore(const Semaphore &) = delete;
+  Semaphore &operator=(const Semaphore &) = delete;
+
+  uint32_t take(const uint32_t ticks_timeout = forever) { return rt_sem_take(&sem, ticks_timeout); }
+  uint32_t take_from_isr(void) { return rt_sem_take_from_isr(&sem); }
+
+  uint32_t give(void)
+  {
+    if constexpr (Max != UINT32_MAX) {
+      CriticalSection cs;
+      return (sem.counter < Max) ? rt_sem_give(&sem) : (uint32_t) RT_NOK;
+    } else {
+      return rt_sem_give(&sem);
+    }
+  }
+
+  uint32_t give_from_isr(void)
+  {
+    if constexpr (Max != UINT32_MAX) {
+      CriticalSection cs;
+      return (sem.counter < Max) ? rt_sem_give_from_isr(&sem) : (uint32_t) RT_NOK;
+    } else {
+      return rt_sem_give_from_isr(&sem);
+    }
+  }
+
+  uint32_t count(void) const { return sem.counter; }
+  rt_sem_t *native(void) { return &sem; }
+
+private:
+  rt_sem_t sem;
+};
+
+template <typename Lockable>
+class Lock {
+  // Takes in the constructor and gives back in the destructor, but only
+  // if it was taken. Check owns() when a timeout is given.
+public:
+  explicit Lock(Lockable &l, const uint32_t ticks_timeout = forever) : lockable(l), taken(l.take(ticks_timeout) == RT_OK) {}
+  ~Lock() { if (taken) lockable.give(); }
+
+  Lock(const Lock &) = delete;
+  Lock &operator=(const Lock &) = delete;
+
+  bool owns(void) const { return taken; }
+  explicit operator bool(void) const { return taken; }
+
+private:
+  Lockable &lockable;
+  const bool taken;
+};
+
+template <typename T, uint32_t N>
+class Queue {
+  static_assert(std::is_trivially_copyable_v<T>, "Queue items are copied as raw memory");
+  static_assert(N > 0, "A queue needs room for at least one item");
+
+public:
+  Queue() { rt_queue_init(&queue, storage, sizeof(T), N); }
+
+  Queue(const Queue &) = delete;
+  Queue &operator=(const Queue &) = delete;
+
+  uint32_t push(const T &item, const uint32_t ticks_timeout = forever) { return rt_queue_push(&queue, &item, ticks_timeout); }
+  uint32_t pull(T &item, const uint32_t ticks_timeout = forever) { return rt_queue_pull(&queue, &item, ticks_timeout); }
+  uint32_t push_front(const T &item, const uint32_t ticks_timeout = forever) { return rt_queue_push_front(&queue, &item, ticks_timeout); }
+
+  // Number of items pulled, see rt_queue_set_threshold
+  uint32_t pull_n(T *items, const uint32_t max_items, const uint32_t ticks_timeout) { return rt_queue_pull_n(&queue, items, max_items, ticks_timeout); }
+  uint32_t push_n(const T *items, const uint32_t n, const uint32_t ticks_timeout) { return rt_queue_push_n(&queue, items, n, ticks_timeout); }
+  uint32_t set_threshold(const uint32_t threshold) { return rt_queue_set_threshold(&queue, threshold); }
+
+  // As the C API: RT_OK if a task of higher prio was unblocked, i.e. yield
+  uint32_t push_from_isr(const T &item) { return rt_queue_push_from_isr(&queue, &item); }
+  uint32_t pull_from_isr(T &item) { return rt_queue_pull_from_isr(&queue, &item); }
+  uint32_t push_n_from_isr(const T *items, const uint32_t n, uint32_t &pushed) { return rt_queue_push_n_from_isr(&queue, items, n, &pushed); }
+  uint32_t pull_n_from_isr(T *items, const uint32_t max_items, uint32_t &pulled) { return rt_queue_pull_n_from_isr(&queue, items, max_items, &pulled); }
+
+  uint32_t items(void) const { return queue.items; }
+  bool full(void) const { return RT_QUEUE_FULL(&queue); }
+  bool empty(void) const { return RT_QUEUE_EMPTY(&queue); }
+  static constexpr uint32_t capacity(void) { return N; }
+  rt_queue_t *native(void) { return &queue; }
+
+private:
+  // Word aligned, so that rt_queue_copy can copy words when sizeof(T) allows
+  static constexpr size_t alignment = (alignof(T) > 4) ? alignof(T) : 4;
+
+  alignas(alignment) uint8_t storage[sizeof(T) * N];
+  rt_queue_t queue;
+};
+
+template <typename T, uint32_t N>
+class PrioQueue {
+  static_assert(std::is_trivially_copyable_v<T>, "Queue items are copied as raw memory");
+  static_assert(N > 0, "A queue needs room for at least one item");
+  static_assert(N < RT_PRIO_QUEUE_END, "Slots are linked by uint16_t, so N must be below RT_PRIO_QUEUE_END");
+
+public:
+  PrioQueue() { rt_prio_queue_init(&queue, storage, sizeof(T), N); }
+
+  PrioQueue(const PrioQueue &) = delete;
+  PrioQueue &operator=(const PrioQueue &) = delete;
+
+  uint32_t push(const T &item, const uint32_t prio, const uint32_t ticks_timeout = forever) { return rt_prio_queue_push(&queue, &item, prio, ticks_timeout); }
+  uint32_t pull(T &item, const uint32_t ticks_timeout = forever) { return rt_prio_queue_pull(&queue, &item, ticks_timeout); }
+
+  uint32_t push_from_isr(const T &item, const uint32_t prio) { return rt_prio_queue_push_from_isr(&queue, &item, prio); }
+  uint32_t pull_from_isr(T &item) { return rt_prio_queue_pull_from_isr(&queue, &item); }
+
+  uint32_t items(void) const { return queue.items; }
+  static constexpr uint32_t capacity(void) { return N; }
+  rt_prio_queue_t *native(void) { return &queue; }
+
+private:
+  static constexpr size_t alignment = (alignof(T) > 4) ? alignof(T) : 4;
+
+  alignas(alignment) uint8_t storage[RT_PRIO_QUEUE_BUFFER_SIZE(sizeof(T), N)];
+  rt_prio_queue_t queue;
+};
+
+template <typename T, uint32_t Slots = 2>
+class Mailbox {
+  static_assert(std::is_trivially_copyable_v<T>, "Values are copied as raw memory");
+  static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0, "Slots must be a power of 2");
+
+public:
+  Mailbox() { rt_mailbox_init(&mb, storage, sizeof(T), Slots); }
+
+  Mailbox(const Mailbox &) = delete;
+  Mailbox &operator=(const Mailbox &) = delete;
+
+  void write(const T &value) { rt_mailbox_write(&mb, &value); }
+  uint32_t write_from_isr(const T &value) { return rt_mailbox_write_from_isr(&mb, &value); }
+  uint32_t read(T &value, uint32_t * const seq = nullptr) { return rt_mailbox_read(&mb, &value, seq); }
+  uint32_t wait(T &value, uint32_t &seq, const uint32_t ticks_timeout = forever) { return rt_mailbox_wait(&mb, &value, &seq, ticks_timeout); }
+
+  uint32_t seq(void) const { return mb.seq; }
+  rt_mailbox_t *native(void) { return &mb; }
+
+private:
+  static constexpr size_t alignment = (alignof(T) > 4) ? alignof(T) : 4;
+
+  alignas(alignment) uint8_t storage[sizeof(T) * Slots];
+  rt_mailbox_t mb;
+};
+
+template <typename T>
+class Shared {
+  static_assert(std::is_trivially_copyable_v<T>, "Values are copied as raw memory");
+
+public:
+  Shared() { rt_shared_init(&sh, &value, sizeof(T)); }
+
+  Shared(const Shared &) = delete;
+  Shared &operator=(const Shared &) = delete;
+
+  void write(const T &v) { rt_shared_write(&sh, &v); }
+  T read(void) const { T v; rt_shared_read(&sh, &v); return v; }
+
+  template <typename F>
+  void update(F &&f) { f(*static_cast<T *>(rt_shared_write_begin(&sh))); rt_shared_write_end(&sh); }
+
+  uint32_t version(void) const { return sh.seq >> 1; }
+  rt_shared_t *native(void) { return &sh; }
+
+private:
+  static constexpr size_t alignment = (alignof(T) > 4) ? alignof(T) : 4;
+
+  alignas(alignment) T value;
+  rt_shared_t sh;
+};
+
+template <typename T>
+class SharedDbuf {
+  static_assert(std::is_trivially_copyable_v<T>, "Values are copied as raw memory");
+
+public:
+  SharedDbuf() { rt_shared_dbuf_init(&db, storage, sizeof(T)); }
+
+  SharedDbuf(const SharedDbuf &) = delete;
+  SharedDbuf &operator=(const SharedDbuf &) = delete;
+
+  void write(const T &v) { rt_shared_dbuf_write(&db, &v); }
+  T read(void) const { T v; rt_shared_dbuf_read(&db, &v); return v; }
+
+  template <typename F>
+  void update(F &&f) { f(*static_cast<T *>(rt_shared_dbuf_write_begin(&db))); rt_shared_dbuf_publish(&db); }
+
+  uint32_t version(void) const { return db.seq; }
+  rt_shared_dbuf_t *native(void) { return &db; }
+
+private:
+  static constexpr size_t alignment = (alignof(T) > 4) ? alignof(T) : 4;
+
+  alignas(alignment) uint8_t storage[2 * sizeof(T)];
+  rt_shared_dbuf_t db;
+};
+
+template <uint32_t Bytes>
+class MsgBuf {
+  static_assert(Bytes >= 8 && Bytes <= 0xFFFC && (Bytes & 3) == 0, "Whole words, room for a header and a word");
+
+public:
+  MsgBuf() { rt_msgbuf_init(&mb, storage, Bytes); }
+
+  MsgBuf(const MsgBuf &) = delete;
+  MsgBuf &operator=(const MsgBuf &) = delete;
+
+  uint32_t send(const void *data, const uint32_t length, const uint32_t ticks_timeout = forever) { return rt_msgbuf_send(&mb, data, length, ticks_timeout); }
+  uint32_t send_from_isr(const void *data, const uint32_t length) { return rt_msgbuf_send_from_isr(&mb, data, length); }
+  uint32_t receive(void *data, const uint32_t max_length, const uint32_t ticks_timeout = forever) { return rt_msgbuf_receive(&mb, data, max_length, ticks_timeout); }
+
+  void *send_reserve(const uint32_t length, const uint32_t ticks_timeout = forever) { return rt_msgbuf_send_reserve(&mb, length, ticks_timeout); }
+  void send_commit(void *data, const uint32_t length) { rt_msgbuf_send_commit(&mb, data, length); }
+  void *receive_reserve(uint32_t &length, const uint32_t ticks_timeout = forever) { return rt_msgbuf_receive_reserve(&mb, &length, ticks_timeout); }
+  void receive_release(void) { rt_msgbuf_receive_release(&mb); }
+
+  uint32_t messages(void) const { return mb.messages; }
+  rt_msgbuf_t *native(void) { return &mb; }
+
+private:
+  alignas(4) uint8_t storage[Bytes];
+  rt_msgbuf_t mb;
+};
+
+template <uint32_t StackWords, uint32_t Prio>
+class Task {
+  static_assert(Prio < RT_PRIO_LEVELS, "Prio must be below RT_PRIO_LEVELS");
+  static_assert(StackWords > RT_STACK_GUARD_WORDS + 16, "Too small for the exception frame");
+
+public:
+  Task(void (*fcn)(void *), const char *name) : tcb TCB_INIT(stack, fcn, name, Prio, StackWords) {}
+
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+
+  uint32_t start(void * const params = nullptr) { return rt_create_task(&tcb, params); }
+  uint32_t stack_high_water(void) { return rt_task_stack_high_water(&tcb); }
+  operator rt_task_t(void) { return &tcb; }
+
+private:
+  alignas(RT_STACK_ALIGNMENT) uint32_t stack[StackWords];
+  rt_tcb_t tcb;
+};
+
+} // namespace rt
+
+#endif /* RT_HPP_ */
@@ -0,0 +1,66 @@
+/*
+ * rt_basic.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_BASIC_H_
+#define RT_BASIC_H_
+
+#include <stdint.h>
+
+#include "rt_kernel_defs.h"
+
+// Basic tasks, as in OSEK: short handlers that run to completion and
+// never block, all on the one stack of the kernel task "BASIC"
+// (RT_BASIC_STACK_SIZE words) instead of a stack of their own.
+//
+//   DEFINE_BASIC_TASK(on_adc, adc_basic, "ADC", 2);
+//
+//   void on_adc(void *p) { ... }      // returns when done
+//
+//   rt_activate(&adc_basic);          // from a task or an ISR
+//
+// The prio of a basic task is the same as that of the ordinary tasks, the
+// BASIC task always runs at the prio of the highest basic task that is
+// active. A basic task that is activated while one of lower prio runs
+// preempts it by nesting on top of it on the shared stack, so the stack
+// has to fit one basic task per prio level in use. An activation while the
+// basic task is pending or running runs it once more afterwards.
+//
+// A basic task must not block, i.e. no rt_sem_take/rt_queue_push/pull
+// with a timeout and no rt_periodic_delay.
+
+typedef struct rt_basic {
+  void (*code)(void *);
+  void *parameters;
+  const char *name;
+  uint32_t priority;
+  volatile uint32_t activations;  // Runs left to do
+  list_item_t list_item;          // In the pending list of its prio
+} rt_basic_t;
+
+#define RT_BASIC_INIT(fcn, params, name, prio) {fcn, params, name, prio, 0, {0, NULL, NULL, NULL, NULL}}
+
+#define DEFINE_BASIC_TASK(fcn, handle, name, prio) \
+  void fcn(void *p);\
+  rt_basic_t handle = RT_BASIC_INIT(fcn, NULL, name, prio);
+
+#if RT_BASIC_ENABLE
+
+#define RT_BASIC_SWITCHED(task)               rt_basic_switched(task)
+
+void rt_basic_init(void);
+uint32_t rt_activate(rt_basic_t * const basic);
+void rt_basic_switched(rt_tcb_t * const task);
+int32_t rt_basic_ceiling_raise(const uint32_t ceiling);
+uint32_t rt_basic_ceiling_restore(const int32_t level, const uint32_t prio);
+
+#else
+
+#define RT_BASIC_SWITCHED(task)               ((void) 0)
+
+#endif
+
+#endif /* RT_BASIC_H_ */
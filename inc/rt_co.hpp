@@ -0,0 +1,468 @@
+/*
+ * rt_co.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_CO_HPP_
+#define RT_CO_HPP_
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include "rt_kernel.h"
+#include "rt_sem.h"
+#include "rt_queue.h"
+}
+
+// Stackless C++20 coroutines run by an executor in a single kernel task.
+// Small activities (protocol handlers, debouncers, LED patterns) then only
+// cost their coroutine frame instead of a TCB and a stack of their own:
+//
+//   rt::co::Executor executor;
+//
+//   rt::co::Activity blink(void)
+//   {
+//     while (1) {
+//       led_toggle();
+//       co_await rt::co::delay(500);
+//     }
+//   }
+//
+//   executor.spawn(blink());
+//   ...
+//   void co_task_fcn(void *p) { executor.run(); }
+//
+// An activity suspends on co_await without blocking the executor task,
+// which runs the other activities meanwhile and sleeps in the kernel when
+// none of them can continue. The awaitables mirror the C API and resume
+// with RT_OK, or RT_NOK on timeout:
+//
+//   co_await rt::co::delay(ticks);
+//   co_await rt::co::yield();
+//   co_await rt::co::take(sem, ticks_timeout);
+//   co_await rt::co::push(queue, &item, ticks_timeout);
+//   co_await rt::co::pull(queue, &item, ticks_timeout);
+//   co_await rt::co::wait(event);
+//
+// Scheduling is cooperative: an activity that does not have to wait
+// keeps running, so a busy one should co_await rt::co::yield() now and
+// then to let the others in.
+//
+// Plain rt_sem_t and rt_queue_t know nothing about the executor, so
+// activities waiting on them are polled every tick. Call
+// executor.notify() after a give/push from another task to resume them
+// right away. An rt::co::Event is signalled with signal_from_isr() and
+// wakes the executor directly, so use that from ISRs.
+//
+// Frames are allocated from a fixed heap of RT_CO_HEAP_SIZE bytes, never
+// from malloc. Needs GCC 10 or later with -std=c++20 (-fcoroutines for
+// GCC 10) and works with -fno-exceptions.
+
+#ifndef RT_CO_HEAP_SIZE
+#define RT_CO_HEAP_SIZE         (2048)  // Bytes for all coroutine frames
+#endif
+
+namespace rt {
+namespace co {
+
+class Heap {
+  // First fit with the free blocks sorted by address, so that neighbours
+  // can be merged again
+  struct Block {
+    size_t size;                // Including the header
+    Block *next;
+  };
+
+  static constexpr size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+  static constexpr size_t header = (sizeof(Block) + align - 1) & ~(align - 1);
+
+  alignas(align) static inline uint8_t storage[RT_CO_HEAP_SIZE];
+  static inline Block *free_list = nullptr;
+  static inline bool initialized = false;
+
+public:
+  static void *alloc(size_t bytes) noexcept
+  {
+    size_t need = (bytes + header + align - 1) & ~(align - 1);
+    void *mem = nullptr;
+
+    rt_enter_critical();
+
+    if (!initialized) {
+      free_list = reinterpret_cast<Block *>(storage);
+      free_list->size = sizeof(storage);
+      free_list->next = nullptr;
+      initialized = true;
+    }
+
+    for (Block **prev = &free_list; *prev != nullptr; prev = &((*prev)->next)) {
+      Block *block = *prev;
+
+      if (block->size < need)
+        continue;
+
+      if (block->size - need >= header + align) {
+        Block *rest = reinterpret_cast<Block *>(reinterpret_cast<uint8_t *>(block) + need);
+        rest->size = block->size - need;
+        rest->next = block->next;
+        block->size = need;
+        *prev = rest;
+      } else {
+        *prev = block->next;
+      }
+
+      mem = reinterpret_cast<uint8_t *>(block) + header;
+      break;
+    }
+
+    rt_exit_critical();
+
+    return mem;
+  }
+
+  static void free(void *mem) noexcept
+  {
+    Block *block = reinterpret_cast<Block *>(static_cast<uint8_t *>(mem) - header);
+    Block **prev = &free_list;
+    Block *before = nullptr;
+
+    rt_enter_critical();
+
+    while (*prev != nullptr && *prev < block) {
+      before = *prev;
+      prev = &((*prev)->next);
+    }
+
+    block->next = *prev;
+    *prev = block;
+
+    if (block->next != nullptr && reinterpret_cast<uint8_t *>(block) + block->size == reinterpret_cast<uint8_t *>(block->next)) {
+      block->size += block->next->size;
+      block->next = block->next->next;
+    }
+
+    if (before != nullptr && reinterpret_cast<uint8_t *>(before) + before->size == reinterpret_cast<uint8_t *>(block)) {
+      before->size += block->size;
+      before->next = block->next;
+    }
+
+    rt_exit_critical();
+  }
+
+  static size_t available(void) noexcept
+  {
+    size_t bytes = initialized ? 0 : sizeof(storage) - header;
+
+    rt_enter_critical();
+    for (Block *block = free_list; block != nullptr; block = block->next)
+      bytes += block->size - header;
+    rt_exit_critical();
+
+    return bytes;
+  }
+};
+
+// A suspended activity, kept in the coroutine frame by the awaitable
+struct Waiter {
+  std::coroutine_handle<> handle;
+  bool (*ready)(Waiter *w);     // Called by the executor, may take the resource
+  uint32_t wake_tick = RT_FOREVER_TICK;
+  bool poll_every_tick = false;
+  uint32_t result = RT_OK;
+  Waiter *next = nullptr;
+
+  bool timed_out(void) const
+  {
+    return wake_tick != RT_FOREVER_TICK && (int32_t) (rt_get_tick() - wake_tick) >= 0;
+  }
+};
+
+class Executor;
+
+class Activity {
+public:
+  struct promise_type {
+    Executor *executor = nullptr;
+    Waiter start;
+
+    Activity get_return_object() { return Activity(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    static Activity get_return_object_on_allocation_failure() { return Activity(); }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() {}
+
+    static void *operator new(size_t bytes) noexcept { return Heap::alloc(bytes); }
+    static void operator delete(void *mem) { Heap::free(mem); }
+  };
+
+  Activity() = default;
+  Activity(Activity &&other) : handle(other.handle) { other.handle = nullptr; }
+  Activity(const Activity &) = delete;
+  ~Activity() { if (handle) handle.destroy(); }
+
+private:
+  explicit Activity(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+  std::coroutine_handle<promise_type> handle = nullptr;
+
+  friend class Executor;
+};
+
+class Executor {
+public:
+  Executor() { rt_sem_init(&wakeup, 0); }
+  Executor(const Executor &) = delete;
+
+  uint32_t spawn(Activity &&activity)
+  {
+    // Returns RT_NOK if the frame did not fit in the heap
+    if (!activity.handle)
+      return RT_NOK;
+
+    Activity::promise_type &promise = activity.handle.promise();
+    promise.executor = this;
+    promise.start.handle = activity.handle;
+    promise.start.ready = [](Waiter *) { return true; };
+    activity.handle = nullptr;
+
+    park(&(promise.start));
+    notify();
+
+    return RT_OK;
+  }
+
+  void park(Waiter *w)
+  {
+    rt_enter_critical();
+    w->next = waiting;
+    waiting = w;
+    rt_exit_critical();
+  }
+
+  void notify(void)
+  {
+    if (wakeup.counter == 0)
+      rt_sem_give(&wakeup);
+  }
+
+  void notify_from_isr(void)
+  {
+    if (wakeup.counter == 0 && rt_sem_give_from_isr(&wakeup) != RT_NOK)
+      rt_pend_yield();
+  }
+
+  [[noreturn]] void run(void)
+  {
+    // The body of the executor task
+    while (1) {
+      uint32_t now = rt_get_tick();
+      uint32_t timeout = 0x7FFFFFFF;
+      Waiter *ready = nullptr;
+
+      rt_enter_critical();
+
+      for (Waiter **prev = &waiting; *prev != nullptr; ) {
+        Waiter *w = *prev;
+
+        if (w->ready(w)) {
+          *prev = w->next;
+          w->next = ready;
+          ready = w;
+          continue;
+        }
+
+        if (w->poll_every_tick)
+          timeout = 1;
+        else if (w->wake_tick != RT_FOREVER_TICK && w->wake_tick - now < timeout)
+          timeout = w->wake_tick - now;
+
+        prev = &(w->next);
+      }
+
+      rt_exit_critical();
+
+      if (ready == nullptr) {
+        rt_sem_take(&wakeup, timeout);
+        continue;
+      }
+
+      while (ready != nullptr) {
+        // The waiter goes away with the co_await expression
+        Waiter *w = ready;
+        ready = w->next;
+        w->handle.resume();
+      }
+    }
+  }
+
+private:
+  rt_sem_t wakeup;
+  Waiter *waiting = nullptr;
+};
+
+struct Awaitable : Waiter {
+  bool await_ready(void) { return ready(this); }
+
+  void await_suspend(std::coroutine_handle<Activity::promise_type> h)
+  {
+    handle = h;
+    h.promise().executor->park(this);
+  }
+
+  uint32_t await_resume(void) { return result; }
+
+protected:
+  void set_timeout(const uint32_t ticks_timeout)
+  {
+    if (ticks_timeout != RT_FOREVER_TICK)
+      wake_tick = rt_get_tick() + ticks_timeout;
+  }
+};
+
+struct Delay : Awaitable {
+  explicit Delay(const uint32_t ticks)
+  {
+    wake_tick = rt_get_tick() + ticks;
+    ready = [](Waiter *w) { return w->timed_out(); };
+  }
+};
+
+struct Yield : Awaitable {
+  Yield() { ready = [](Waiter *) { return true; }; }
+
+  bool await_ready(void) { return false; }
+};
+
+// Take, Push and Pull wait on plain rt_sem_t and rt_queue_t, which do not
+// wake the executor. They are polled every tick, so each adds up to one
+// tick of latency unless the giver calls executor.notify().
+
+struct Take : Awaitable {
+  Take(rt_sem_t &s, const uint32_t ticks_timeout) : sem(&s)
+  {
+    set_timeout(ticks_timeout);
+    poll_every_tick = true;
+    ready = [](Waiter *w) {
+      Take *t = static_cast<Take *>(w);
+      t->result = rt_sem_take_from_isr(t->sem);
+      return t->result == RT_OK || t->timed_out();
+    };
+  }
+
+  rt_sem_t *sem;
+};
+
+struct Push : Awaitable {
+  Push(rt_queue_t &q, const void *i, const uint32_t ticks_timeout) : queue(&q), item(i)
+  {
+    set_timeout(ticks_timeout);
+    poll_every_tick = true;
+    ready = [](Waiter *w) {
+      Push *p = static_cast<Push *>(w);
+      p->result = RT_NOK;
+
+      rt_enter_critical();
+      if (!RT_QUEUE_FULL(p->queue)) {
+        if (rt_queue_push_from_isr(p->queue, p->item) != RT_NOK)
+          rt_pend_yield();
+        p->result = RT_OK;
+      }
+      rt_exit_critical();
+
+      return p->result == RT_OK || p->timed_out();
+    };
+  }
+
+  rt_queue_t *queue;
+  const void *item;
+};
+
+struct Pull : Awaitable {
+  Pull(rt_queue_t &q, void *i, const uint32_t ticks_timeout) : queue(&q), item(i)
+  {
+    set_timeout(ticks_timeout);
+    poll_every_tick = true;
+    ready = [](Waiter *w) {
+      Pull *p = static_cast<Pull *>(w);
+      p->result = RT_NOK;
+
+      rt_enter_critical();
+      if (!RT_QUEUE_EMPTY(p->queue)) {
+        if (rt_queue_pull_from_isr(p->queue, p->item) != RT_NOK)
+          rt_pend_yield();
+        p->result = RT_OK;
+      }
+      rt_exit_critical();
+
+      return p->result == RT_OK || p->timed_out();
+    };
+  }
+
+  rt_queue_t *queue;
+  void *item;
+};
+
+class Event {
+  // Set from an ISR or task, consumed by one waiting activity
+public:
+  explicit Event(Executor &e) : executor(&e) {}
+
+  void signal(void)
+  {
+    flag = true;
+    executor->notify();
+  }
+
+  void signal_from_isr(void)
+  {
+    flag = true;
+    executor->notify_from_isr();
+  }
+
+  bool consume(void)
+  {
+    bool was_set;
+
+    rt_enter_critical();
+    was_set = flag;
+    flag = false;
+    rt_exit_critical();
+
+    return was_set;
+  }
+
+private:
+  Executor *executor;
+  volatile bool flag = false;
+};
+
+struct Wait : Awaitable {
+  Wait(Event &e, const uint32_t ticks_timeout) : event(&e)
+  {
+    set_timeout(ticks_timeout);
+    ready = [](Waiter *w) {
+      Wait *t = static_cast<Wait *>(w);
+      t->result = t->event->consume() ? RT_OK : RT_NOK;
+      return t->result == RT_OK || t->timed_out();
+    };
+  }
+
+  Event *event;
+};
+
+inline Delay delay(const uint32_t ticks) { return Delay(ticks); }
+inline Yield yield(void) { return Yield(); }
+inline Take take(rt_sem_t &sem, const uint32_t ticks_timeout = RT_FOREVER_TICK) { return Take(sem, ticks_timeout); }
+inline Push push(rt_queue_t &queue, const void *item, const uint32_t ticks_timeout = RT_FOREVER_TICK) { return Push(queue, item, ticks_timeout); }
+inline Pull pull(rt_queue_t &queue, void *item, const uint32_t ticks_timeout = RT_FOREVER_TICK) { return Pull(queue, item, ticks_timeout); }
+inline Wait wait(Event &event, const uint32_t ticks_timeout = RT_FOREVER_TICK) { return Wait(event, ticks_timeout); }
+
+} // namespace co
+} // namespace rt
+
+#endif /* RT_CO_HPP_ */
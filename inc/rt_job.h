@@ -0,0 +1,61 @@
+/*
+ * rt_job.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_JOB_H_
+#define RT_JOB_H_
+
+#include <stdint.h>
+
+#include "rt_kernel_defs.h"
+
+// Measurement of the jobs of periodic tasks. A job is released when the
+// tick wakes a task up from rt_periodic_delay, and is done when the task
+// calls rt_periodic_delay again. For each job the kernel keeps track of
+// (all in cycles of rt_get_cycles, i.e. DWT on the target):
+//
+//   exec      time the task was running, which includes any ISRs but not
+//             the time it was preempted by other tasks
+//   response  time from the release until done
+//   start     time from the release until it was first switched in
+//
+// and counts the jobs that were done after the deadline, which is
+// tcb.timing.deadline if set and the period otherwise. A job that is done
+// after the next release was due releases the next one at once, which is
+// counted in late_releases. The stats are kept in the TCB and read with
+// rt_job_stats_get.
+//
+// All hooks compile to nothing unless RT_JOB_STATS_ENABLE is set.
+
+// Called in the context of the task, right after a job was done too late
+typedef void (*rt_job_overrun_hook_t)(rt_tcb_t *task, const uint32_t response_cycles);
+
+#if RT_JOB_STATS_ENABLE
+
+#define RT_JOB_RELEASE(task)                  rt_job_release(task)
+#define RT_JOB_LATE_RELEASE(task)             rt_job_late_release(task)
+#define RT_JOB_SWITCH(prev_task, next_task)   rt_job_switch((prev_task), (next_task))
+#define RT_JOB_DONE(task, period)             rt_job_done((task), (period))
+
+void rt_job_release(rt_tcb_t * const task);
+void rt_job_late_release(rt_tcb_t * const task);
+void rt_job_switch(rt_tcb_t * const prev_task, rt_tcb_t * const next_task);
+void rt_job_done(rt_tcb_t * const task, const uint32_t period);
+
+void rt_job_stats_get(rt_tcb_t * const task, rt_job_stats_t *stats);
+void rt_job_stats_reset(rt_tcb_t * const task);
+void rt_job_set_overrun_hook(rt_job_overrun_hook_t hook);
+
+#else
+
+#define RT_JOB_RELEASE(task)                  ((void) 0)
+#define RT_JOB_LATE_RELEASE(task)             ((void) 0)
+#define RT_JOB_SWITCH(prev_task, next_task)   ((void) 0)
+#define RT_JOB_DONE(task, period)             ((void) 0)
+
+#endif
+
+#endif /* RT_JOB_H_ */
@@ -9,27 +9,52 @@
 #define RT_KERNEL_H_
 
 #include <stdint.h>
-#include "stm32f4xx_hal.h"
 
 #include "rt_kernel_defs.h"
+#include "rt_port.h"
 #include "rt_lists.h"
+#include "rt_trace.h"
+#include "rt_job.h"
+#include "rt_latency.h"
+#include "rt_obj.h"
+#include "rt_basic.h"
+#include "rt_resource.h"
 
+#define TCB_INIT_TIMING(sp, fcn, name, prio, stack_size, period, deadline, wcet_us, blocking_us) \
+  {sp, (void *) (fcn), name, prio, prio, stack_size, sp, 0, 0, LIST_ITEM_INIT, LIST_ITEM_INIT, NULL, {period, deadline, wcet_us, blocking_us}}
 
-#define rt_systick              SysTick_Handler
-#define rt_switch_context       PendSV_Handler
-#define rt_syscall              SVC_Handler
-
-#define TCB_INIT(sp, fcn, name, prio, stack_size) {sp, fcn, name, prio, prio, stack_size, 0, LIST_ITEM_INIT, LIST_ITEM_INIT}
+#define TCB_INIT(sp, fcn, name, prio, stack_size) TCB_INIT_TIMING(sp, fcn, name, prio, stack_size, 0, 0, 0, 0)
 
 #define DEFINE_TASK(fcn, handle, name, prio, stack_size) \
   void fcn(void *p);\
-  uint32_t handle ## _stack[stack_size];\
+  uint32_t handle ## _stack[stack_size] __attribute__((aligned(RT_STACK_ALIGNMENT)));\
   rt_tcb_t handle = TCB_INIT(handle ## _stack, fcn, name, prio, stack_size);
 
+// As DEFINE_TASK, for a task released every period ticks (typically by
+// rt_periodic_delay) that has to finish within deadline ticks. The timing
+// is checked by tools/rt_rta.py as part of the build, so keep the
+// arguments plain numbers or simple defines.
+#define DEFINE_PERIODIC_TASK(fcn, handle, name, prio, stack_size, period, deadline, wcet_us, blocking_us) \
+  void fcn(void *p);\
+  uint32_t handle ## _stack[stack_size] __attribute__((aligned(RT_STACK_ALIGNMENT)));\
+  rt_tcb_t handle = TCB_INIT_TIMING(handle ## _stack, fcn, name, prio, stack_size, period, deadline, wcet_us, blocking_us);
+
+// A task that is part of the static image. With RT_STATIC_IMAGE_ENABLE
+// its tcb, its stack with the initial frame and its place in the ready
+// list are generated by tools/rt_image.py into .data, so the task is ready
+// before main and rt_create_task does not have to be called. Tasks of the
+// same prio run in the order they are declared. params is copied as is
+// into the generated file, so keep it NULL or a number. Without the option
+// it is a plain DEFINE_TASK, to be created with rt_create_task as usual.
+#if RT_STATIC_IMAGE_ENABLE
+#define DEFINE_STATIC_TASK(fcn, handle, name, prio, stack_size, params) \
+  void fcn(void *p);\
+  extern rt_tcb_t handle;
+#else
+#define DEFINE_STATIC_TASK(fcn, handle, name, prio, stack_size, params) \
+  DEFINE_TASK(fcn, handle, name, prio, stack_size)
+#endif
 
-void rt_systick();
-void rt_switch_context() __attribute__((naked));
-void rt_syscall()        __attribute__((naked));
 
 void rt_yield(void);
 
@@ -40,59 +65,23 @@ void rt_resume(void);
 uint32_t rt_get_tick(void);
 void rt_periodic_delay(const uint32_t period);
 uint32_t rt_create_task(rt_task_t const task, void * const task_parameters);
+uint32_t rt_task_stack_high_water(rt_task_t const task);
+rt_task_t rt_task_list(void);
 void rt_start();
 uint32_t rt_init();
 
+// Used by the port
+uint32_t rt_increment_tick();
+void rt_switch_task();
+void rt_error_handler(uint8_t err);
 
-ALWAYS_INLINE static void rt_pend_yield()
-{
-  SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
-  __asm volatile (
-    " dsb    \n\t"
-    " isb    \n\t"
-  );
-}
-
-ALWAYS_INLINE static void rt_enable_irq(void)
-{
-  __asm volatile (
-    " cpsie if    \n\t"
-  );
-}
-
-ALWAYS_INLINE static void rt_disable_irq(void)
-{
-  __asm volatile (
-    " cpsid if    \n\t"
-  );
-}
-
-ALWAYS_INLINE static void rt_mask_irq(void)
-{
-  uint32_t tmp = RT_MASK_IRQ_PRIO;
-
-  __asm volatile (
-
-    " msr basepri, %0  \n\t"
-    :
-    : "r" (tmp)
-  );
-}
-
-ALWAYS_INLINE static void rt_unmask_irq(void)
-{
-  uint32_t tmp = 0;
-
-  __asm volatile (
-
-    " msr basepri, %0  \n\t"
-    :
-    : "r" (tmp)
-  );
-}
 
 extern rt_task_t volatile current_task;
 extern volatile uint32_t next_wakeup_tick;
 extern rt_task_t volatile next_wakeup_task;
 
+#if RT_STATIC_IMAGE_ENABLE
+extern rt_task_t const rt_image_task_list; // Generated, see DEFINE_STATIC_TASK
+#endif
+
 #endif /* RT_KERNEL_H_ */
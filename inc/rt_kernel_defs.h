@@ -13,17 +13,84 @@
 #define RT_KERNEL_IRQ_PRIO      (0x0F)
 #define RT_MASK_IRQ_PRIO        (0x06<<4) // ISR's with a logical prio higher than this may NOT use kernel functionality!
 #define RT_IDLE_TASK_STACK_SIZE (512)
+#define RT_STACK_FILL_PATTERN   (0xA5A5A5A5)
 #define RT_PRIO_LEVELS          (4)
 
 #define RT_FOREVER_TICK         (0xFFFFFFFF)
 
+#ifndef RT_STACK_MONITOR_ENABLE
+#define RT_STACK_MONITOR_ENABLE (1)     // Idle task keeps the stack high water mark of each task up to date
+#endif
+
+#ifndef RT_MPU_STACK_GUARD_ENABLE
+#define RT_MPU_STACK_GUARD_ENABLE (0)   // Make the lowest RT_STACK_GUARD_SIZE bytes of the running task's stack inaccessible
+#endif
+#define RT_STACK_GUARD_SIZE     (32)    // Bytes, power of 2 and >= 32
+#define RT_STACK_GUARD_MPU_SIZE (4)     // Region size field: 2^(4+1) = 32 bytes
+#define RT_STACK_GUARD_MPU_REGION (7)   // Highest number, overrides any other region
+
+#if RT_MPU_STACK_GUARD_ENABLE
+#define RT_STACK_GUARD_WORDS    (RT_STACK_GUARD_SIZE/4)
+#define RT_STACK_ALIGNMENT      (RT_STACK_GUARD_SIZE)
+#else
+#define RT_STACK_GUARD_WORDS    (0)
+#define RT_STACK_ALIGNMENT      (8)
+#endif
+
+#ifndef RT_TRACE_ENABLE
+#define RT_TRACE_ENABLE         (0)     // Record kernel events into rt_trace, see rt_trace.h
+#endif
+#define RT_TRACE_BUFFER_RECORDS (256)   // Must be a power of 2
+
+#ifndef RT_TRACE_ITM_ENABLE
+#define RT_TRACE_ITM_ENABLE     (0)     // Stream the trace records over ITM/SWO, Cortex-M only
+#endif
+#define RT_TRACE_ITM_PORT       (1)     // Uses stimulus ports RT_TRACE_ITM_PORT to RT_TRACE_ITM_PORT+2
+#define RT_TRACE_SWO_HZ         (2000000)
+
+#ifndef RT_PROF_ENABLE
+#define RT_PROF_ENABLE          (0)     // PC-sampling profiler, see rt_prof.h
+#endif
+#define RT_PROF_SLOTS           (512)   // Histogram size, must be a power of 2
+
+#ifndef RT_JOB_STATS_ENABLE
+#define RT_JOB_STATS_ENABLE     (0)     // Measure each job of the tasks using rt_periodic_delay, see rt_job.h
+#endif
+
+#ifndef RT_LATENCY_ENABLE
+#define RT_LATENCY_ENABLE       (0)     // ISR to task wakeup latency histogram per sem/queue, see rt_latency.h
+#endif
+#define RT_LATENCY_SUB_BITS     (2)     // 2^RT_LATENCY_SUB_BITS buckets per power of 2
+#define RT_LATENCY_BUCKETS      (64)    // Everything above the last bucket is counted in it
+
+#ifndef RT_OBJ_STATS_ENABLE
+#define RT_OBJ_STATS_ENABLE     (0)     // Contention stats and a registry of all sems and queues, see rt_obj.h
+#endif
+
+#ifndef RT_BASIC_ENABLE
+#define RT_BASIC_ENABLE         (0)     // Run to completion basic tasks on a shared stack, see rt_basic.h
+#endif
+#define RT_BASIC_STACK_SIZE     (512)   // Words, shared by all basic tasks
+
+#ifndef RT_WAITSET_ENABLE
+#define RT_WAITSET_ENABLE       (0)     // Wait for any of several sems, queues and notifications, see rt_waitset.h
+#endif
+#define RT_WAITSET_MEMBERS      (8)     // Per set, at most 32
+
+#define RT_PRIO_QUEUE_LEVELS    (8)     // Message prios of rt_prio_queue_t, at most 32
+
+#ifndef RT_STATIC_IMAGE_ENABLE
+#define RT_STATIC_IMAGE_ENABLE  (0)     // Tasks of DEFINE_STATIC_TASK are prebuilt by tools/rt_image.py, Cortex-M only
+#endif
+
 enum {
   RT_NOK = 0,
   RT_OK
 };
 
 enum {
-  RT_ERR_STARTFAILURE = 0
+  RT_ERR_STARTFAILURE = 0,
+  RT_ERR_STACKOVERFLOW
 };
 
 struct item {
@@ -41,15 +108,55 @@ typedef struct {
 } list_sorted_t;
 
 typedef struct {
+  uint32_t period;                // Ticks, 0 if the task is not periodic
+  uint32_t deadline;              // Ticks after each release
+  uint32_t wcet_us;               // Declared or measured worst case execution time
+  uint32_t blocking_us;           // Longest time it may keep higher prio tasks from running
+} rt_task_timing_t;
+
+typedef struct {
+  uint32_t jobs;
+  uint32_t overruns;              // Jobs that finished after their deadline
+  uint32_t exec_min;              // Cycles the job was running, preemption excluded
+  uint32_t exec_max;
+  uint64_t exec_sum;
+  uint32_t response_min;          // Cycles from the release to the next rt_periodic_delay
+  uint32_t response_max;
+  uint32_t start_min;             // Cycles from the release to the first time it ran,
+  uint32_t start_max;             // the start jitter is start_max - start_min
+  uint32_t late_releases;         // Jobs released at once, the previous one was done too late to wait
+} rt_job_stats_t;
+
+typedef struct {
+  rt_job_stats_t stats;
+  uint32_t release;               // Current job
+  uint32_t release_tick;
+  uint32_t exec;
+  uint32_t switched_in;
+  uint32_t state;
+} rt_job_t;
+
+typedef struct rt_tcb {
   volatile void *sp;
   void *code_start;
   const char *task_name;
   uint32_t priority;
   uint32_t base_prio;
   uint32_t stack_size;
+  uint32_t *stack_start;
+  volatile uint32_t stack_peak;   // Words, as of the last rt_task_stack_high_water
   uint32_t delay_woken_tick;
   struct item list_item;
   struct item blocked_list_item;
+  struct rt_tcb *next_task;       // All created tasks
+  rt_task_timing_t timing;        // For the response time analysis, tools/rt_rta.py
+#if RT_JOB_STATS_ENABLE
+  rt_job_t job;
+#endif
+#if RT_LATENCY_ENABLE
+  struct rt_latency_hist *latency_hist; // Where to record the wakeup latency, if woken by an ISR
+  uint32_t latency_start;
+#endif
 } rt_tcb_t;
 
 typedef rt_tcb_t* rt_task_t;
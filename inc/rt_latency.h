@@ -0,0 +1,58 @@
+/*
+ * rt_latency.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_LATENCY_H_
+#define RT_LATENCY_H_
+
+#include <stdint.h>
+
+#include "rt_kernel_defs.h"
+
+// Wakeup latency from an ISR to the task it unblocks. When e.g.
+// rt_sem_give_from_isr unblocks a task, the give is timestamped in the
+// woken task's TCB, and when the task returns from rt_sem_take the time
+// since then is added to a histogram kept in the semaphore (or queue). So
+// the latency includes the rest of the ISR, PendSV, the context switch
+// and any higher prio task that ran in between.
+//
+// The histogram is log-linear like HdrHistogram: bucket i < 2^S counts
+// exactly i cycles, above that each power of 2 is split in 2^S linear
+// buckets, S = RT_LATENCY_SUB_BITS. With S = 2 the error is at most 25%.
+// rt_latency_bucket_low gives the lowest cycle count of a bucket.
+//
+// Only gives from ISRs are measured, and all hooks compile to nothing
+// unless RT_LATENCY_ENABLE is set.
+
+typedef struct rt_latency_hist {
+  uint32_t count;
+  uint32_t min;             // Cycles
+  uint32_t max;
+  uint32_t bucket[RT_LATENCY_BUCKETS];
+} rt_latency_hist_t;
+
+#if RT_LATENCY_ENABLE
+
+#define RT_LATENCY_INIT(hist)                 rt_latency_reset(hist)
+#define RT_LATENCY_GIVE(task, hist)           rt_latency_give((task), (hist))
+#define RT_LATENCY_WOKEN(task)                rt_latency_woken(task)
+
+void rt_latency_give(rt_tcb_t * const task, rt_latency_hist_t * const hist);
+void rt_latency_woken(rt_tcb_t * const task);
+
+void rt_latency_read(rt_latency_hist_t * const hist, rt_latency_hist_t *copy);
+void rt_latency_reset(rt_latency_hist_t * const hist);
+uint32_t rt_latency_bucket_low(const uint32_t bucket);
+
+#else
+
+#define RT_LATENCY_INIT(hist)                 ((void) 0)
+#define RT_LATENCY_GIVE(task, hist)           ((void) 0)
+#define RT_LATENCY_WOKEN(task)                ((void) 0)
+
+#endif
+
+#endif /* RT_LATENCY_H_ */
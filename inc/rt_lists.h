@@ -47,6 +47,7 @@ void rt_lists_delayed_init(void);
 
 void rt_list_task_ready(rt_task_t const task);
 void rt_list_task_ready_next(rt_task_t const task);
+void rt_list_task_prio(rt_task_t const task, const uint32_t prio);
 
 void rt_list_task_delayed(rt_task_t const task, const uint32_t wake_up_tick);
 void rt_list_task_undelayed(rt_task_t const task);
@@ -0,0 +1,58 @@
+/*
+ * rt_mailbox.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_MAILBOX_H_
+#define RT_MAILBOX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rt_lists.h"
+#include "rt_latency.h"
+#include "rt_obj.h"
+
+// Latest value mailbox, e.g. for sensor samples where only the newest
+// one matters. A write always succeeds and overwrites the oldest of the
+// slots. A read returns the newest value along with its sequence number,
+// which is the number of writes so far, so 0 means nothing yet:
+//
+//   rt_mailbox_write_from_isr(&imu, &sample);
+//
+//   uint32_t seq = 0;
+//   while (rt_mailbox_wait(&imu, &sample, &seq, timeout) == RT_OK)
+//     ...                            // every time there is a newer one
+//
+// Reads do not lock. A read copies the newest slot and is retried if a
+// write started on that slot in the meantime (a seqlock), so it never
+// returns a torn value and never blocks a writer. Writers may still
+// preempt a read that copies a slot they are about to write. With more
+// slots, slots-1 writes can run during a read before it has to be
+// retried, so use 2 or more if writes are frequent compared to the time
+// a read takes. slots must be a power of 2.
+
+typedef struct {
+  uint8_t *buffer;
+  uint32_t item_size;
+  uint32_t slots;
+  volatile uint32_t seq;          // Writes done, the newest is in slot seq % slots
+  volatile uint32_t started;      // Writes started
+  list_sorted_t blocked;          // Waiting for a newer seq
+#if RT_LATENCY_ENABLE
+  rt_latency_hist_t latency;
+#endif
+#if RT_OBJ_STATS_ENABLE
+  rt_obj_t obj;
+#endif
+} rt_mailbox_t;
+
+uint32_t rt_mailbox_init(rt_mailbox_t *mb, uint8_t *buffer, uint32_t item_size, uint32_t slots);
+uint32_t rt_mailbox_write_from_isr(rt_mailbox_t *mb, const void * const item);
+uint32_t rt_mailbox_write(rt_mailbox_t *mb, const void * const item);
+uint32_t rt_mailbox_read(rt_mailbox_t *mb, void * const item, uint32_t * const seq);
+uint32_t rt_mailbox_wait(rt_mailbox_t *mb, void * const item, uint32_t * const seq, const uint32_t ticks_timeout);
+
+#endif /* RT_MAILBOX_H_ */
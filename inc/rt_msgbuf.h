@@ -0,0 +1,69 @@
+/*
+ * rt_msgbuf.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_MSGBUF_H_
+#define RT_MSGBUF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rt_lists.h"
+#include "rt_latency.h"
+#include "rt_obj.h"
+
+// Message buffer for messages of any length, unlike rt_queue_t where every
+// slot has to fit the largest one. Each message is a record of a 4 byte
+// header and the data padded to whole words, one after the other in the
+// ring. A record never wraps around, the end of the buffer is skipped
+// instead, so a message can be written and read in place:
+//
+//   uint8_t *p = rt_msgbuf_send_reserve(&mb, 64, timeout);
+//   ...fill in up to 64 bytes...
+//   rt_msgbuf_send_commit(&mb, p, 40);
+//
+//   p = rt_msgbuf_receive_reserve(&mb, &length, timeout);
+//   ...
+//   rt_msgbuf_receive_release(&mb);
+//
+// Messages are received in the order they were reserved, a message that is
+// not yet committed holds up the ones after it. rt_msgbuf_send and
+// rt_msgbuf_receive copy instead. Reserving or sending from an ISR is fine
+// with a timeout of 0, or use rt_msgbuf_send_from_isr.
+//
+// Only one receive reservation can be outstanding, so a buffer that is
+// read in place should have a single receiver.
+//
+// The buffer must be word aligned. Messages are 1 to size-4 bytes.
+
+typedef struct {
+  uint8_t *buffer;
+  uint32_t size;                  // Bytes, whole words up to 0xFFFC
+  uint32_t head;                  // Where the next record goes
+  uint32_t tail;                  // The oldest record
+  uint32_t used;                  // Bytes in records and skipped ends
+  uint32_t messages;              // Committed and not yet received
+  list_sorted_t blocked_send;
+  list_sorted_t blocked_receive;
+#if RT_LATENCY_ENABLE
+  rt_latency_hist_t latency;
+#endif
+#if RT_OBJ_STATS_ENABLE
+  rt_obj_t obj;
+#endif
+} rt_msgbuf_t;
+
+uint32_t rt_msgbuf_init(rt_msgbuf_t *mb, uint8_t *buffer, uint32_t size);
+uint32_t rt_msgbuf_send(rt_msgbuf_t *mb, const void * const data, const uint32_t length, const uint32_t ticks_timeout);
+uint32_t rt_msgbuf_send_from_isr(rt_msgbuf_t *mb, const void * const data, const uint32_t length);
+uint32_t rt_msgbuf_receive(rt_msgbuf_t *mb, void * const data, const uint32_t max_length, const uint32_t ticks_timeout);
+
+void * rt_msgbuf_send_reserve(rt_msgbuf_t *mb, const uint32_t length, const uint32_t ticks_timeout);
+void rt_msgbuf_send_commit(rt_msgbuf_t *mb, void * const data, const uint32_t length);
+void * rt_msgbuf_receive_reserve(rt_msgbuf_t *mb, uint32_t * const length, const uint32_t ticks_timeout);
+void rt_msgbuf_receive_release(rt_msgbuf_t *mb);
+
+#endif /* RT_MSGBUF_H_ */
@@ -0,0 +1,83 @@
+/*
+ * rt_obj.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_OBJ_H_
+#define RT_OBJ_H_
+
+#include <stdint.h>
+
+#include "rt_kernel_defs.h"
+
+// Contention statistics for the kernel objects tasks may block on. Each
+// semaphore, queue and message buffer gets an rt_obj_t (member obj) that
+// is registered when the object is initialized. Walk all of them with
+// rt_obj_list() and obj->next_obj, like rt_task_list(), to find the
+// objects that tasks spend their time blocked on:
+//
+//   acquisitions  successful takes, pushes, pulls, sends and receives
+//   contended     the ones that had to block first
+//   timeouts      blocked and gave up
+//   wait          cycles spent blocked, total and max
+//   max_depth     highest sem count or number of queued items/messages
+//
+// Give an object a name with RT_OBJ_NAME(&sem, "ADC"). All hooks compile
+// to nothing unless RT_OBJ_STATS_ENABLE is set.
+
+enum {
+  RT_OBJ_SEM = 1,
+  RT_OBJ_QUEUE,
+  RT_OBJ_MSGBUF,
+  RT_OBJ_MAILBOX
+};
+
+typedef struct {
+  uint32_t acquisitions;
+  uint32_t contended;
+  uint32_t timeouts;
+  uint32_t wait_max;        // Cycles
+  uint64_t wait_sum;
+  uint32_t max_depth;
+} rt_obj_stats_t;
+
+typedef struct rt_obj {
+  const char *name;
+  uint32_t type;
+  rt_obj_stats_t stats;
+  struct rt_obj *next_obj;  // All registered objects
+} rt_obj_t;
+
+#if RT_OBJ_STATS_ENABLE
+
+#define RT_OBJ_NAME(pobj, obj_name)           rt_obj_set_name(&((pobj)->obj), (obj_name))
+#define RT_OBJ_REGISTER(obj, type)            rt_obj_register((obj), (type))
+#define RT_OBJ_ACQUIRE(obj, depth)            rt_obj_acquire((obj), (depth))
+#define RT_OBJ_DEPTH(obj, depth)              rt_obj_depth((obj), (depth))
+#define RT_OBJ_WAIT_START()                   rt_get_cycles()
+#define RT_OBJ_WAITED(obj, start, acquired)   rt_obj_waited((obj), (start), (acquired))
+
+void rt_obj_register(rt_obj_t * const obj, const uint32_t type);
+void rt_obj_acquire(rt_obj_t * const obj, const uint32_t depth);
+void rt_obj_depth(rt_obj_t * const obj, const uint32_t depth);
+void rt_obj_waited(rt_obj_t * const obj, const uint32_t start, const uint32_t acquired);
+
+void rt_obj_set_name(rt_obj_t * const obj, const char *name);
+rt_obj_t * rt_obj_list(void);
+void rt_obj_stats_get(rt_obj_t * const obj, rt_obj_stats_t *stats);
+void rt_obj_stats_reset(rt_obj_t * const obj);
+
+#else
+
+#define RT_OBJ_NAME(pobj, obj_name)           ((void) 0)
+#define RT_OBJ_REGISTER(obj, type)            ((void) 0)
+#define RT_OBJ_ACQUIRE(obj, depth)            ((void) 0)
+#define RT_OBJ_DEPTH(obj, depth)              ((void) 0)
+#define RT_OBJ_WAIT_START()                   (0)
+#define RT_OBJ_WAITED(obj, start, acquired)   ((void) (start))
+
+#endif
+
+#endif /* RT_OBJ_H_ */
@@ -0,0 +1,62 @@
+/*
+ * rt_prio_queue.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_PRIO_QUEUE_H_
+#define RT_PRIO_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rt_lists.h"
+#include "rt_latency.h"
+#include "rt_obj.h"
+
+// Queue that is pulled by the prio given to each push, highest first and
+// FIFO within a prio, so that an urgent command does not wait behind a
+// burst of telemetry. Prios are 0 to RT_PRIO_QUEUE_LEVELS-1.
+//
+// All prios share the max_items slots. Each prio has a list of its slots
+// and a bit in a bitmap that tells if it has any, so both push and pull
+// are O(1). The buffer holds the slots followed by their links:
+//
+//   uint8_t buffer[RT_PRIO_QUEUE_BUFFER_SIZE(sizeof(cmd_t), 16)];
+//   rt_prio_queue_init(&cmd_queue, buffer, sizeof(cmd_t), 16);
+//
+// For a single urgent item in an rt_queue_t, see rt_queue_push_front.
+
+#define RT_PRIO_QUEUE_END   (0xFFFF)   // No slot, so at most 0xFFFE items
+
+#define RT_PRIO_QUEUE_BUFFER_SIZE(item_size, max_items) \
+  ((((item_size) * (max_items) + 1) & ~1u) + sizeof(uint16_t) * (max_items))
+
+typedef struct {
+  uint8_t *buffer;
+  uint16_t *link;                 // Next slot in the same list, per slot
+  uint32_t items;
+  uint32_t max_items;
+  uint32_t item_size;
+  uint32_t levels;                // Bit per prio that has items
+  uint16_t head[RT_PRIO_QUEUE_LEVELS];
+  uint16_t tail[RT_PRIO_QUEUE_LEVELS];
+  uint16_t free;                  // List of the free slots
+  list_sorted_t blocked_pull;
+  list_sorted_t blocked_push;
+#if RT_LATENCY_ENABLE
+  rt_latency_hist_t latency;
+#endif
+#if RT_OBJ_STATS_ENABLE
+  rt_obj_t obj;
+#endif
+} rt_prio_queue_t;
+
+uint32_t rt_prio_queue_init(rt_prio_queue_t *queue, uint8_t *buffer, uint32_t item_size, uint32_t max_items);
+uint32_t rt_prio_queue_push_from_isr(rt_prio_queue_t *queue, const void * const item, const uint32_t prio);
+uint32_t rt_prio_queue_push(rt_prio_queue_t *queue, const void * const item, const uint32_t prio, const uint32_t ticks_timeout);
+uint32_t rt_prio_queue_pull_from_isr(rt_prio_queue_t *queue, void * const item);
+uint32_t rt_prio_queue_pull(rt_prio_queue_t *queue, void * const item, const uint32_t ticks_timeout);
+
+#endif /* RT_PRIO_QUEUE_H_ */
@@ -0,0 +1,56 @@
+/*
+ * rt_prof.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_PROF_H_
+#define RT_PROF_H_
+
+#include <stdint.h>
+
+#include "rt_kernel_defs.h"
+
+// Statistical PC-sampling profiler. A timer interrupt with a logical prio
+// above RT_MASK_IRQ_PRIO (so that kernel critical sections are sampled too)
+// picks the stacked PC of the interrupted context and counts it in a
+// (pc, context) histogram. The context is current_task, or the exception
+// number if an ISR was interrupted.
+//
+// Dump rt_prof with a debugger (gdb: dump binary value prof.bin rt_prof)
+// and symbolize it with tools/rt_prof.py.
+
+#define RT_PROF_MAGIC           (0x52545046) // "RTPF"
+#define RT_PROF_VERSION         (1)
+
+#define RT_PROF_TIM             TIM5
+#define RT_PROF_TIM_CLK_ENABLE  __TIM5_CLK_ENABLE
+#define RT_PROF_IRQn            TIM5_IRQn
+#define RT_PROF_IRQHandler      TIM5_IRQHandler
+#define RT_PROF_IRQ_PRIO        (1)
+#define RT_PROF_MAX_PROBES      (8)
+
+typedef struct {
+  uint32_t pc;
+  uint32_t context;   // tcb address, or exception number (< 0x200) if an ISR
+  uint32_t count;
+} rt_prof_slot_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slots;
+  uint32_t sample_hz;
+  volatile uint32_t samples;
+  volatile uint32_t dropped;  // Samples that did not fit in the histogram
+  rt_prof_slot_t slot[RT_PROF_SLOTS];
+} rt_prof_t;
+
+uint32_t rt_prof_start(const uint32_t sample_hz);
+void rt_prof_stop(void);
+void rt_prof_reset(void);
+
+extern rt_prof_t rt_prof;
+
+#endif /* RT_PROF_H_ */
@@ -12,8 +12,11 @@
 #include <stdint.h>
 
 #include "rt_lists.h"
+#include "rt_latency.h"
+#include "rt_obj.h"
+#include "rt_waitset.h"
 
-typedef struct {
+typedef struct rt_queue {
   uint8_t *buffer_start;
   uint8_t *buffer_end;
   uint8_t *next;
@@ -21,8 +24,19 @@ typedef struct {
   uint32_t items;
   uint32_t max_items;
   uint32_t item_size;
+  uint32_t threshold;             // Items that wake a blocked puller
+  uint32_t pull_wait;             // The least any blocked puller waits for
   list_sorted_t blocked_pull;
   list_sorted_t blocked_push;
+#if RT_LATENCY_ENABLE
+  rt_latency_hist_t latency;
+#endif
+#if RT_OBJ_STATS_ENABLE
+  rt_obj_t obj;
+#endif
+#if RT_WAITSET_ENABLE
+  rt_waitset_link_t waitset;
+#endif
 } rt_queue_t;
 
 #define RT_QUEUE_FULL(pqueue) ( ((rt_queue_t *) (pqueue))->items == ((rt_queue_t *) (pqueue))->max_items )
@@ -34,4 +48,28 @@ uint32_t rt_queue_push(rt_queue_t *queue, const void * const item, const uint32_
 uint32_t rt_queue_pull_from_isr(rt_queue_t *queue, void * const item);
 uint32_t rt_queue_pull(rt_queue_t *queue, void * const item, const uint32_t ticks_timeout);
 
+// Urgent items, pulled before everything that is queued already
+uint32_t rt_queue_push_front_from_isr(rt_queue_t *queue, const void * const item);
+uint32_t rt_queue_push_front(rt_queue_t *queue, const void * const item, const uint32_t ticks_timeout);
+
+// Batching for byte streams and the like: a blocked puller is only woken
+// when there are threshold items (1 by default), which includes a full
+// queue, or else when its ticks_timeout runs out. rt_queue_pull_n then
+// takes all there are in one go, up to max_items, and returns how many.
+// Asked for fewer than threshold, it is woken once there are max_items.
+uint32_t rt_queue_set_threshold(rt_queue_t *queue, uint32_t threshold);
+uint32_t rt_queue_pull_n(rt_queue_t *queue, void * const items, const uint32_t max_items, const uint32_t ticks_timeout);
+
+// Up to n items with one critical section, e.g. from a DMA half/full
+// transfer callback. rt_queue_push_n blocks only while the queue is full
+// and returns how many it pushed. The _from_isr variants never block,
+// return RT_OK if a higher prio task was unblocked as the others do and
+// tell the count through pushed/pulled.
+uint32_t rt_queue_push_n(rt_queue_t *queue, const void * const items, const uint32_t n, const uint32_t ticks_timeout);
+uint32_t rt_queue_push_n_from_isr(rt_queue_t *queue, const void * const items, const uint32_t n, uint32_t * const pushed);
+uint32_t rt_queue_pull_n_from_isr(rt_queue_t *queue, void * const items, const uint32_t max_items, uint32_t * const pulled);
+
+// Copies whole words when dst, src and size allow it, also for rt_msgbuf
+void rt_queue_copy(uint8_t *dst, const uint8_t *src, uint32_t size);
+
 #endif /* RT_QUEUE_H_ */
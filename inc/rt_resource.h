@@ -0,0 +1,59 @@
+/*
+ * rt_resource.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_RESOURCE_H_
+#define RT_RESOURCE_H_
+
+#include <stdint.h>
+
+#include "rt_kernel_defs.h"
+
+// Resources with the immediate priority ceiling protocol (as in OSEK, and
+// the Stack Resource Policy for fixed prios). The ceiling is the highest
+// prio of the tasks that use the resource. rt_resource_get raises the
+// caller to it at once, so no other user can run until it is released
+// and nobody ever waits for it:
+//
+//   DEFINE_RESOURCE(spi_bus, 3);
+//
+//   rt_resource_get(&spi_bus);
+//   ...
+//   rt_resource_release(&spi_bus);
+//
+// Deadlock is impossible and a task is blocked by lower prio tasks at
+// most once, before it starts. That only holds if the holder does not
+// block and releases in reverse order of getting, and it is what lets
+// basic tasks (rt_basic.h) of the same prio share the stack. Basic tasks
+// of higher prio than the running one but not above the ceiling stay
+// pending until it is released. Tasks at the ceiling prio do not get any
+// round robin time from the holder either.
+//
+// Tasks only, not ISRs.
+
+typedef struct {
+  uint32_t ceiling;
+  uint32_t prev_prio;             // Of the holder, restored on release
+  rt_task_t prev_holder;          // Of rt_resource_holder
+#if RT_BASIC_ENABLE
+  int32_t prev_level;
+#endif
+} rt_resource_t;
+
+#define RT_RESOURCE_INIT(ceiling) {ceiling, 0, NULL}
+
+#define DEFINE_RESOURCE(handle, ceiling) \
+  rt_resource_t handle = RT_RESOURCE_INIT(ceiling);
+
+void rt_resource_init(rt_resource_t *resource, uint32_t ceiling);
+uint32_t rt_resource_get(rt_resource_t *resource);
+uint32_t rt_resource_release(rt_resource_t *resource);
+
+// The task that got a resource last, which rt_switch_task keeps running
+// instead of round robin with the other tasks at the ceiling
+extern rt_task_t volatile rt_resource_holder;
+
+#endif /* RT_RESOURCE_H_ */
@@ -12,11 +12,23 @@
 #include <stdint.h>
 
 #include "rt_lists.h"
+#include "rt_latency.h"
+#include "rt_obj.h"
+#include "rt_waitset.h"
 
 
-typedef struct {
+typedef struct rt_sem {
   volatile uint32_t counter;
   list_sorted_t blocked;
+#if RT_LATENCY_ENABLE
+  rt_latency_hist_t latency;
+#endif
+#if RT_OBJ_STATS_ENABLE
+  rt_obj_t obj;
+#endif
+#if RT_WAITSET_ENABLE
+  rt_waitset_link_t waitset;
+#endif
 } rt_sem_t;
 
 void rt_sem_init(rt_sem_t *sem, uint32_t count);
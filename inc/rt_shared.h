@@ -0,0 +1,106 @@
+/*
+ * rt_shared.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_SHARED_H_
+#define RT_SHARED_H_
+
+#include <stdint.h>
+
+#include "rt_kernel.h"
+#include "rt_queue.h"
+
+// State shared by a writer and any number of readers, e.g. a config block
+// of the control task. Readers never block, never enter the kernel and
+// never hold up the writer. They read optimistically and retry if a write
+// got in between, which is checked against a sequence number that every
+// write bumps (a seqlock):
+//
+//   DEFINE_SHARED(params, params_t);
+//
+//   params_t *p = rt_shared_write_begin(&params);
+//   p->gain = 2.0f;
+//   rt_shared_write_end(&params);
+//
+//   rt_shared_read(&params, &copy);     // or, without copying:
+//
+//   do {
+//     seq = rt_shared_read_begin(&params);
+//     gain = params_data.gain;
+//   } while (rt_shared_read_retry(&params, seq));
+//
+// rt_shared_t is updated in place within a critical section, so no reader
+// can run in the middle of it. That keeps the interrupts masked for as
+// long as the update takes, which is fine for small structs. Readers must
+// be tasks or ISRs the kernel masks.
+//
+// rt_shared_dbuf_t is for large structs. It has two copies, and the writer
+// fills the one that is not current and then publishes it, without
+// masking anything. Only one writer at a time, and the readers can be any
+// ISR. A reader only has to retry if it is preempted by two writes. The
+// buffer holds both copies, 2 * size bytes.
+
+typedef struct {
+  void *data;
+  uint32_t size;
+  volatile uint32_t seq;          // Odd during a write
+} rt_shared_t;
+
+typedef struct {
+  uint8_t *buffer;
+  uint32_t size;
+  volatile uint32_t seq;          // Publishes, the current copy is seq % 2
+  volatile uint32_t started;      // Writes begun
+} rt_shared_dbuf_t;
+
+#define RT_SHARED_INIT(data) {&(data), sizeof(data), 0}
+
+#define DEFINE_SHARED(handle, type) \
+  type handle##_data; \
+  rt_shared_t handle = RT_SHARED_INIT(handle##_data);
+
+void rt_shared_init(rt_shared_t *sh, void *data, uint32_t size);
+void *rt_shared_write_begin(rt_shared_t *sh);
+void rt_shared_write_end(rt_shared_t *sh);
+void rt_shared_write(rt_shared_t *sh, const void * const value);
+uint32_t rt_shared_read(const rt_shared_t *sh, void * const value);
+
+void rt_shared_dbuf_init(rt_shared_dbuf_t *db, uint8_t *buffer, uint32_t size);
+void *rt_shared_dbuf_write_begin(rt_shared_dbuf_t *db);
+void rt_shared_dbuf_publish(rt_shared_dbuf_t *db);
+void rt_shared_dbuf_write(rt_shared_dbuf_t *db, const void * const value);
+uint32_t rt_shared_dbuf_read(const rt_shared_dbuf_t *db, void * const value);
+
+ALWAYS_INLINE static uint32_t rt_shared_read_begin(const rt_shared_t *sh)
+{
+  uint32_t seq = sh->seq;
+  rt_port_barrier();
+  return seq;
+}
+
+ALWAYS_INLINE static uint32_t rt_shared_read_retry(const rt_shared_t *sh, const uint32_t seq)
+{
+  // Non-zero if what was read since rt_shared_read_begin may be torn
+  rt_port_barrier();
+  return (seq & 1) | (sh->seq ^ seq);
+}
+
+ALWAYS_INLINE static const void *rt_shared_dbuf_read_begin(const rt_shared_dbuf_t *db, uint32_t * const seq)
+{
+  // The current copy, valid until rt_shared_dbuf_read_retry says otherwise
+  *seq = db->seq;
+  rt_port_barrier();
+  return db->buffer + (*seq & 1) * db->size;
+}
+
+ALWAYS_INLINE static uint32_t rt_shared_dbuf_read_retry(const rt_shared_dbuf_t *db, const uint32_t seq)
+{
+  // Non-zero if a write started on the copy that was read
+  rt_port_barrier();
+  return (db->started - seq) >= 2;
+}
+
+#endif /* RT_SHARED_H_ */
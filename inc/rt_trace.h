@@ -0,0 +1,109 @@
+/*
+ * rt_trace.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_TRACE_H_
+#define RT_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rt_kernel_defs.h"
+
+// Kernel event recorder. Each event is stored as a timestamped record in a
+// RAM ring buffer (rt_trace) which always holds the latest
+// RT_TRACE_BUFFER_RECORDS events. The buffer can be dumped with a debugger
+// (e.g. gdb: dump binary value trace.bin rt_trace) or drained by a transport
+// using rt_trace_read(), and converted by tools/rt_trace.py.
+//
+// With RT_TRACE_ITM_ENABLE set, the ITM is the reader instead. Each record
+// is sent as four words, the first on stimulus port RT_TRACE_ITM_PORT and
+// the rest on the next port, so that a decoder can resynchronize after a
+// lost packet. The total number of lost records is sent on the third
+// port whenever it changes. Sending never waits for the ITM FIFO: what
+// does not fit stays in the ring buffer and is flushed by the next record,
+// tick or idle loop, or counted as lost if it gets overwritten first.
+// Convert a raw SWO capture with tools/rt_trace.py --swo.
+//
+// All hooks compile to nothing unless RT_TRACE_ENABLE is set.
+
+#define RT_TRACE_MAGIC          (0x52545452) // "RTTR"
+#define RT_TRACE_VERSION        (1)
+
+enum {
+  RT_TRACE_EVT_TASK_CREATE = 1,   // data: task prio
+  RT_TRACE_EVT_SWITCH_IN,
+  RT_TRACE_EVT_SWITCH_OUT,
+  RT_TRACE_EVT_BLOCK,             // object: the sem/queue blocked on
+  RT_TRACE_EVT_UNBLOCK,           // object: the sem/queue that released the task
+  RT_TRACE_EVT_DELAY,             // data: lower 16 bits of the wake up tick
+  RT_TRACE_EVT_WAKE,              // task removed from the delayed list
+  RT_TRACE_EVT_ISR_ENTER,         // data: exception number, task: the interrupted task
+  RT_TRACE_EVT_ISR_EXIT
+};
+
+typedef struct {
+  uint32_t timestamp;   // DWT cycle counter
+  uint32_t task;        // tcb address
+  uint32_t object;      // kernel object address, if any
+  uint8_t event;
+  uint8_t prio;         // task prio at the time of the event
+  uint16_t data;
+} rt_trace_record_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t max_records;
+  uint32_t cpu_hz;
+  volatile uint32_t head;   // Total number of records written
+  volatile uint32_t tail;   // Total number of records consumed by rt_trace_read
+  volatile uint32_t lost;   // Records overwritten before rt_trace_read got them
+  rt_trace_record_t record[RT_TRACE_BUFFER_RECORDS];
+} rt_trace_t;
+
+#if RT_TRACE_ENABLE
+
+#define RT_TRACE_TASK_CREATE(task)            rt_trace_record(RT_TRACE_EVT_TASK_CREATE, (task), NULL, (task)->priority)
+#define RT_TRACE_SWITCH_IN(task)              rt_trace_record(RT_TRACE_EVT_SWITCH_IN, (task), NULL, 0)
+#define RT_TRACE_SWITCH_OUT(task)             rt_trace_record(RT_TRACE_EVT_SWITCH_OUT, (task), NULL, 0)
+#define RT_TRACE_BLOCK(task, obj)             rt_trace_record(RT_TRACE_EVT_BLOCK, (task), (obj), 0)
+#define RT_TRACE_UNBLOCK(task, obj)           rt_trace_record(RT_TRACE_EVT_UNBLOCK, (task), (obj), 0)
+#define RT_TRACE_DELAY(task, wake_up_tick)    rt_trace_record(RT_TRACE_EVT_DELAY, (task), NULL, (uint16_t) (wake_up_tick))
+#define RT_TRACE_WAKE(task)                   rt_trace_record(RT_TRACE_EVT_WAKE, (task), NULL, 0)
+#define RT_TRACE_ISR_ENTER()                  rt_trace_record(RT_TRACE_EVT_ISR_ENTER, current_task, NULL, (uint16_t) rt_port_active_irq())
+#define RT_TRACE_ISR_EXIT()                   rt_trace_record(RT_TRACE_EVT_ISR_EXIT, current_task, NULL, (uint16_t) rt_port_active_irq())
+
+#if RT_TRACE_ITM_ENABLE
+#define RT_TRACE_FLUSH()                      rt_trace_itm_flush()
+#else
+#define RT_TRACE_FLUSH()                      ((void) 0)
+#endif
+
+#else
+
+#define RT_TRACE_TASK_CREATE(task)            ((void) 0)
+#define RT_TRACE_SWITCH_IN(task)              ((void) 0)
+#define RT_TRACE_SWITCH_OUT(task)             ((void) 0)
+#define RT_TRACE_BLOCK(task, obj)             ((void) 0)
+#define RT_TRACE_UNBLOCK(task, obj)           ((void) 0)
+#define RT_TRACE_DELAY(task, wake_up_tick)    ((void) 0)
+#define RT_TRACE_WAKE(task)                   ((void) 0)
+#define RT_TRACE_ISR_ENTER()                  ((void) 0)
+#define RT_TRACE_ISR_EXIT()                   ((void) 0)
+#define RT_TRACE_FLUSH()                      ((void) 0)
+
+#endif
+
+void rt_trace_init(void);
+void rt_trace_record(const uint8_t event, rt_tcb_t * const task, const void * const object, const uint16_t data);
+uint32_t rt_trace_read(rt_trace_record_t *records, const uint32_t max_records);
+void rt_trace_itm_flush(void);
+
+extern rt_trace_t rt_trace;
+
+#endif /* RT_TRACE_H_ */
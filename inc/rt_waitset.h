@@ -0,0 +1,78 @@
+/*
+ * rt_waitset.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_WAITSET_H_
+#define RT_WAITSET_H_
+
+#include <stdint.h>
+
+#include "rt_kernel_defs.h"
+
+// Wait for any of several semaphores, queues and notifications at once,
+// instead of polling each with a short timeout:
+//
+//   rt_waitset_add_queue(&set, &cmd_queue, CMD);
+//   rt_waitset_add_sem(&set, &adc_done, ADC);
+//   rt_waitset_add_notify(&set, STOP);
+//
+//   while (rt_waitset_wait(&set, &id, timeout) == RT_OK) {
+//     switch (id) {
+//     case CMD: rt_queue_pull(&cmd_queue, &cmd, 0); ...
+//
+// Each member has an id of its own below RT_WAITSET_MEMBERS. A queue is
+// ready when it has threshold items (see rt_queue_set_threshold), a
+// semaphore when its count is not 0 and a notification when it has been
+// given with rt_waitset_notify. rt_waitset_wait returns the ready member
+// with the lowest id but does not take anything, except the notification.
+//
+// Giving or pushing to a member flags it in its set and wakes the waiting
+// task directly, so both adding and waking are O(1). A flag only means
+// that the member may be ready, rt_waitset_wait checks it before
+// returning it. One task waits on a set, and an object is in one set.
+
+struct rt_waitset;
+
+typedef struct {
+  struct rt_waitset *set;         // NULL if not in one
+  uint32_t id;
+} rt_waitset_link_t;
+
+typedef struct rt_waitset {
+  volatile uint32_t flagged;      // Members that may be ready, one bit per id
+  volatile uint32_t notified;     // Notifications that are given
+  void *member[RT_WAITSET_MEMBERS];
+  uint8_t type[RT_WAITSET_MEMBERS];
+  rt_task_t volatile waiting;     // Blocked in rt_waitset_wait
+} rt_waitset_t;
+
+struct rt_sem;
+struct rt_queue;
+
+#if RT_WAITSET_ENABLE
+
+#define RT_WAITSET_LINK_INIT(link)            ((link)->set = NULL)
+#define RT_WAITSET_SIGNAL(link)               (((link)->set != NULL) ? rt_waitset_signal((link)->set, (link)->id) : RT_NOK)
+
+void rt_waitset_init(rt_waitset_t *ws);
+uint32_t rt_waitset_add_sem(rt_waitset_t *ws, struct rt_sem *sem, const uint32_t id);
+uint32_t rt_waitset_add_queue(rt_waitset_t *ws, struct rt_queue *queue, const uint32_t id);
+uint32_t rt_waitset_add_notify(rt_waitset_t *ws, const uint32_t id);
+uint32_t rt_waitset_notify_from_isr(rt_waitset_t *ws, const uint32_t id);
+uint32_t rt_waitset_notify(rt_waitset_t *ws, const uint32_t id);
+uint32_t rt_waitset_wait(rt_waitset_t *ws, uint32_t * const id, const uint32_t ticks_timeout);
+
+// Used by the members
+uint32_t rt_waitset_signal(rt_waitset_t *ws, const uint32_t id);
+
+#else
+
+#define RT_WAITSET_LINK_INIT(link)            ((void) 0)
+#define RT_WAITSET_SIGNAL(link)               (RT_NOK)
+
+#endif
+
+#endif /* RT_WAITSET_H_ */
@@ -0,0 +1,311 @@
+/*
+ * rt_port.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_kernel.h"
+#include "rt_port.h"
+
+static uint32_t rt_init_interrupt_prios();
+#if RT_MPU_STACK_GUARD_ENABLE
+static void rt_stack_guard_init();
+#endif
+#if RT_TRACE_ENABLE && RT_TRACE_ITM_ENABLE
+static void rt_itm_init();
+#endif
+#if RT_BASIC_ENABLE
+static void rt_port_nest_return(void) __attribute__((naked));
+void rt_port_nest_restore(uint32_t *saved) __attribute__((used));
+#endif
+
+rt_task_t volatile stack_overflow_task = NULL;
+
+// MemManage fault status bits (CFSR)
+#define RT_CFSR_MSTKERR   (1UL << 4)
+#define RT_CFSR_MMARVALID (1UL << 7)
+
+#define RT_CONTROL_FPCA   (1UL << 2)
+
+#if RT_STATIC_IMAGE_ENABLE
+// First instruction of the tasks in the static image, see
+// RT_PORT_STACK_IMAGE. A plain label and not a function, so that its
+// address stays even.
+__asm (
+  "  .pushsection .text         \n\t"
+  "  .align 2                   \n\t"
+  "  .global rt_port_task_entry \n\t"
+  "rt_port_task_entry:          \n\t"
+  "  bx r1                      \n\t"
+  "  .popsection                \n\t"
+);
+#endif
+
+void rt_port_init(void)
+{
+  // Cycle counter
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+#if RT_TRACE_ENABLE && RT_TRACE_ITM_ENABLE
+  rt_itm_init();
+#endif
+}
+
+#if RT_TRACE_ENABLE && RT_TRACE_ITM_ENABLE
+static void rt_itm_init()
+{
+  // SWO in UART (NRZ) mode on PB3 at RT_TRACE_SWO_HZ. A debugger that sets
+  // up the TPIU itself will simply override this.
+  DBGMCU->CR = (DBGMCU->CR & ~DBGMCU_CR_TRACE_MODE) | DBGMCU_CR_TRACE_IOEN;
+
+  TPI->SPPR = 2;
+  TPI->ACPR = SystemCoreClock / RT_TRACE_SWO_HZ - 1;
+  TPI->FFCR = 0x100; // No formatter, only ITM packets on the wire
+
+  ITM->LAR = 0xC5ACCE55;
+  ITM->TCR = ITM_TCR_ITMENA_Msk | (1UL << ITM_TCR_TraceBusID_Pos);
+  ITM->TER |= 7UL << RT_TRACE_ITM_PORT;
+}
+#endif
+
+void * rt_port_init_stack(rt_task_t const task, void * const task_parameters)
+{
+  uint32_t *stackptr = task->stack_start;
+  uint32_t i;
+
+#if RT_MPU_STACK_GUARD_ENABLE
+  if ((uint32_t) stackptr & (RT_STACK_GUARD_SIZE-1))
+    return NULL;
+#endif
+
+  // Paint the stack so that the high water mark can be found later
+  for (i = 0; i < task->stack_size; i++)
+    stackptr[i] = RT_STACK_FILL_PATTERN;
+
+  stackptr = (uint32_t*) &stackptr[task->stack_size-1];
+
+  // Needs to be 8-byte aligned
+  if ((uint32_t) stackptr & 0x04) {
+    stackptr--;
+  }
+
+  // PSR
+  *stackptr-- = (uint32_t) 0x01000000;
+
+  // PC, as PC is loaded on exit from ISR, bit0 must be zero
+  *stackptr-- = (uint32_t) task->code_start & 0xFFFFFFFE;
+
+  // LR: Use non-floating point popping and use psp when returning
+  *stackptr = (uint32_t) 0xFFFFFFFD;
+
+  // R12, R3, R2, R1
+  stackptr -= 5;
+
+  // R0
+  *stackptr-- = (uint32_t) task_parameters;
+
+  *stackptr = (uint32_t) 0xFFFFFFFD;
+
+  // R11, R10, R9, R8, R7, R6, R5, R4
+  stackptr -= 8;
+
+  return stackptr;
+}
+
+#if RT_BASIC_ENABLE
+void rt_port_nest(rt_task_t const task, void (*code)(const uint32_t), const uint32_t parameter)
+{
+  // Called by rt_switch_task, i.e. in PendSV with the task's context saved
+  // at task->sp. A new frame below it makes the task call code(parameter)
+  // when it is switched in, and return to rt_port_nest_return when done.
+  uint32_t *saved = (uint32_t *) task->sp;
+  uint32_t *stackptr;
+
+  // The word above the frame is where rt_port_nest_return finds the saved
+  // context. The sp has to be 8-byte aligned when code is called.
+  stackptr = (uint32_t *) (((uint32_t) (saved - 1)) & ~0x07);
+  *stackptr = (uint32_t) saved;
+
+  // PSR, PC and LR
+  *--stackptr = (uint32_t) 0x01000000;
+  *--stackptr = (uint32_t) code & 0xFFFFFFFE;
+  *--stackptr = (uint32_t) rt_port_nest_return;
+
+  // R12, R3, R2, R1
+  stackptr -= 4;
+
+  // R0
+  *--stackptr = parameter;
+
+  *--stackptr = (uint32_t) 0xFFFFFFFD;
+
+  // R11, R10, R9, R8, R7, R6, R5, R4
+  stackptr -= 8;
+
+  task->sp = stackptr;
+}
+
+static void rt_port_nest_return(void)
+{
+  // The sp is back where rt_port_nest put the saved context
+  __asm volatile (
+    " ldr r0, [sp]              \n\t"
+    " b rt_port_nest_restore    \n\t"
+  );
+}
+
+void rt_port_nest_restore(uint32_t *saved)
+{
+  // Continue from where the task was before rt_port_nest. rt_syscall
+  // restores the context at current_task->sp, and masking keeps PendSV
+  // from saving over it first.
+  rt_mask_irq();
+  current_task->sp = saved;
+
+  // Whatever fp state the nested code left is dropped, so that the svc
+  // does not reserve room for it and leave a lazy save pending
+  __set_CONTROL(__get_CONTROL() & ~RT_CONTROL_FPCA);
+  __ISB();
+
+  __asm volatile (" svc 0 ");
+}
+#endif
+
+static uint32_t rt_init_interrupt_prios()
+{
+  NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4); // No sub-priorities
+
+  NVIC_SetPriority(PendSV_IRQn, RT_KERNEL_IRQ_PRIO);    // Set lowest prio
+  NVIC_SetPriority(SysTick_IRQn, RT_KERNEL_IRQ_PRIO);
+
+  return RT_OK;
+}
+
+#if RT_MPU_STACK_GUARD_ENABLE
+static void rt_stack_guard_init()
+{
+  MPU->CTRL = 0;
+
+  // No access at all, not even privileged
+  MPU->RNR = RT_STACK_GUARD_MPU_REGION;
+  MPU->RBAR = 0;
+  MPU->RASR = MPU_RASR_XN_Msk | (RT_STACK_GUARD_MPU_SIZE << MPU_RASR_SIZE_Pos);
+
+  SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+
+  // Keep the default memory map for everything else
+  MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+
+  __DSB();
+  __ISB();
+}
+
+void rt_stack_guard_fault(void)
+{
+  // Should be called by MemManage_Handler.
+  // Either the exception stacking or an access hit the guard.
+  uint32_t cfsr = SCB->CFSR;
+  uint32_t guard = (uint32_t) current_task->stack_start;
+
+  if ((cfsr & RT_CFSR_MSTKERR) || ((cfsr & RT_CFSR_MMARVALID) && (SCB->MMFAR - guard) < RT_STACK_GUARD_SIZE)) {
+    // current_task->task_name tells who did it
+    stack_overflow_task = current_task;
+    rt_error_handler(RT_ERR_STACKOVERFLOW);
+  }
+}
+#endif
+
+void rt_port_start(void)
+{
+#if RT_MPU_STACK_GUARD_ENABLE
+  rt_stack_guard_init();
+  rt_port_task_switched(current_task);
+  MPU->RASR |= MPU_RASR_ENABLE_Msk;
+#endif
+
+  if (rt_init_interrupt_prios()) {
+    // Brace yourselves, the kernel is starting!
+    rt_unmask_irq();
+    rt_enable_irq();
+
+    __asm volatile (" svc 0 " );  // Need to be in handler mode to restore correctly => system call
+  }
+}
+
+void rt_syscall()
+{
+  __asm volatile (
+    " ldr r0, [%[SP]]           \n\t"
+    " ldmia r0!, {r4-r11, lr}   \n\t"
+    " tst lr, #0x10             \n\t" // Pop upper floating point regs if used by process,
+    " it eq                     \n\t" // for a context restored by rt_port_nest_restore
+    " vldmiaeq r0!, {s16-s31}   \n\t"
+    " msr psp, r0               \n\t" // Restore the process stack pointer
+    " mov r0, #0                \n\t" // The task was running unmasked
+    " msr basepri, r0           \n\t"
+    " isb                       \n\t"
+    " bx lr                     \n\t"
+    :
+    : [SP] "r" (&(current_task->sp))
+    :
+  );
+}
+
+void rt_systick()
+{
+  RT_TRACE_ISR_ENTER();
+
+  HAL_IncTick();
+
+  rt_mask_irq();
+
+  if (RT_OK==rt_increment_tick())
+    rt_pend_yield();
+
+  rt_unmask_irq();
+
+  RT_TRACE_ISR_EXIT();
+}
+
+void rt_switch_context()
+{
+  __asm volatile (
+    " mrs r0, psp               \n\t" // psp -> r0
+    " isb                       \n\t" // Instruction synchronization barrier
+    " tst lr, #0x10             \n\t" // Check LR:
+    " it eq                     \n\t" // Push upper floating point regs if used by process
+    " vstmdbeq r0!, {s16-s31}   \n\t"
+    "                           \n\t"
+    " stmdb r0!, {r4-r11, lr}   \n\t" // Push rest of core regs, and specifically lr so that
+    "                           \n\t" // it can be checked by switcher for fp use when restoring
+    " str r0, [%[SP]]           \n\t" // Store current stack-pointer to tcb
+    " dsb                       \n\t"
+    " isb                       \n\t"
+    " bl rt_switch_task         \n\t" // Possibly change context to next process
+    "                           \n\t"
+    :
+    : [SP] "r" (&(current_task->sp))
+    :
+  );
+
+  // Split inline assembly to force re-evaluation of current_task (updated by context switcher)
+
+  __asm volatile (
+    " ldr r0, [%[SP]]           \n\t" // Get stack-pointer from tcb
+    " ldmia r0!, {r4-r11, lr}   \n\t" // Pop rest of core regs, and specifically lr
+    "                           \n\t"
+    " tst lr, #0x10             \n\t" // Check LR:
+    " it eq                     \n\t" // Pop upper floating point regs if used by process
+    " vldmiaeq r0!, {s16-s31}   \n\t"
+    "                           \n\t"
+    " msr psp, r0               \n\t" // Restore the process stack pointer
+    " isb                       \n\t"
+    " bx lr                     \n\t" // Continue next task
+    :
+    : [SP] "r" (&(current_task->sp))
+    :
+  );
+}
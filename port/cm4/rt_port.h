@@ -0,0 +1,153 @@
+/*
+ * rt_port.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_PORT_H_
+#define RT_PORT_H_
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+#include "rt_kernel_defs.h"
+#include "debug.h"
+
+// Cortex-M4 port: PendSV does the context switch, SVC starts the first
+// task and SysTick drives the kernel tick.
+
+#define rt_systick              SysTick_Handler
+#define rt_switch_context       PendSV_Handler
+#define rt_syscall              SVC_Handler
+
+#define RT_PORT_CYCLES_HZ       (SystemCoreClock)
+
+void rt_systick();
+void rt_switch_context() __attribute__((naked));
+void rt_syscall()        __attribute__((naked));
+
+void rt_port_init(void);
+void * rt_port_init_stack(rt_task_t const task, void * const task_parameters);
+void rt_port_start(void);
+void rt_stack_guard_fault(void);
+void rt_port_nest(rt_task_t const task, void (*code)(const uint32_t), const uint32_t parameter);
+
+// The frame of rt_port_init_stack as an initializer, for the tasks of the
+// static image. The stacked PC must be even, which the link time address
+// of a Thumb function never is, so it is rt_port_task_entry with the task
+// in r1.
+#define RT_PORT_STACK_TOP(stack_size)       (((stack_size) - 1) & ~1)   // Word index, 8-byte aligned
+#define RT_PORT_STACK_IMAGE_SP(stack_size)  (RT_PORT_STACK_TOP(stack_size) - 16)
+#define RT_PORT_STACK_IMAGE(stack_size, fcn, params) { \
+  [0 ... (stack_size) - 1] = RT_STACK_FILL_PATTERN, \
+  [RT_PORT_STACK_TOP(stack_size) - 8] = 0xFFFFFFFD, (uint32_t) (params), (uint32_t) (fcn), \
+  [RT_PORT_STACK_TOP(stack_size) - 2] = 0xFFFFFFFD, (uint32_t) rt_port_task_entry, 0x01000000}
+
+extern const uint8_t rt_port_task_entry[];
+
+extern rt_task_t volatile stack_overflow_task;
+
+// Single core, and the M4 does not reorder its own accesses as seen by
+// its interrupts, so only the compiler has to be kept in order
+#define rt_port_barrier()       __asm volatile ("" ::: "memory")
+
+ALWAYS_INLINE static void rt_pend_yield()
+{
+  SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
+  __asm volatile (
+    " dsb    \n\t"
+    " isb    \n\t"
+  );
+}
+
+ALWAYS_INLINE static uint32_t rt_get_cycles(void)
+{
+  return DWT->CYCCNT;
+}
+
+ALWAYS_INLINE static void rt_enable_irq(void)
+{
+  __asm volatile (
+    " cpsie if    \n\t"
+  );
+}
+
+ALWAYS_INLINE static void rt_disable_irq(void)
+{
+  __asm volatile (
+    " cpsid if    \n\t"
+  );
+}
+
+ALWAYS_INLINE static void rt_mask_irq(void)
+{
+  uint32_t tmp = RT_MASK_IRQ_PRIO;
+
+  __asm volatile (
+
+    " msr basepri, %0  \n\t"
+    :
+    : "r" (tmp)
+  );
+}
+
+ALWAYS_INLINE static void rt_unmask_irq(void)
+{
+  uint32_t tmp = 0;
+
+  __asm volatile (
+
+    " msr basepri, %0  \n\t"
+    :
+    : "r" (tmp)
+  );
+}
+
+ALWAYS_INLINE static uint32_t rt_port_irq_save(void)
+{
+  // Masks all interrupts, not only those below RT_MASK_IRQ_PRIO
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  return primask;
+}
+
+ALWAYS_INLINE static void rt_port_irq_restore(const uint32_t primask)
+{
+  __set_PRIMASK(primask);
+}
+
+ALWAYS_INLINE static uint32_t rt_port_active_irq(void)
+{
+  // Exception number, 0 in thread mode
+  return __get_IPSR();
+}
+
+ALWAYS_INLINE static uint32_t rt_port_itm_ready(const uint32_t port)
+{
+  // Reads as zero if the FIFO is full, or if ITM or the port is disabled
+  return ITM->PORT[port].u32;
+}
+
+ALWAYS_INLINE static void rt_port_itm_write(const uint32_t port, const uint32_t word)
+{
+  ITM->PORT[port].u32 = word;
+}
+
+ALWAYS_INLINE static void rt_port_idle(void)
+{
+  DBG_PAD4_SET;
+}
+
+ALWAYS_INLINE static void rt_port_task_switched(rt_task_t const task)
+{
+#if RT_MPU_STACK_GUARD_ENABLE
+  // Writing RBAR with VALID set selects the region as well, its
+  // attributes are set once by rt_port_start
+  MPU->RBAR = (uint32_t) task->stack_start | MPU_RBAR_VALID_Msk | RT_STACK_GUARD_MPU_REGION;
+#endif
+
+  DBG_PAD4_RESET;
+}
+
+#endif /* RT_PORT_H_ */
@@ -0,0 +1,164 @@
+/*
+ * rt_basic_test.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "rt_kernel.h"
+#include "rt_sem.h"
+
+// Test of the basic tasks on the host port, built with RT_BASIC_ENABLE:
+//
+//   make basic
+//
+// Checks that BASIC always runs at the prio of the basic task on top of
+// the stack, so that ordinary tasks are ordered with the basic tasks as in
+// the ready lists, and that basic tasks of higher prio nest on top of a
+// running one, when activated from it or from an ISR. Each step appends to
+// a log, which is compared with what is expected. Returns non-zero on a
+// mismatch.
+
+#define TEST_TIMEOUT  (0x7FFFFFFF)
+#define TEST_LOG_SIZE (64)
+
+static void test_main_fcn(void *p);
+static void test_waiter_fcn(void *p);
+static void test_log(const char c, const uint32_t prio);
+static rt_task_t test_basic_task(void);
+
+DEFINE_TASK(test_main_fcn, test_main, "MAIN", RT_PRIO_LEVELS-1, 256);
+DEFINE_TASK(test_waiter_fcn, test_waiter, "WAITER", 2, 256);
+
+DEFINE_BASIC_TASK(test_b1_fcn, test_b1, "B1", 1);
+DEFINE_BASIC_TASK(test_b3_fcn, test_b3, "B3", 3);
+DEFINE_BASIC_TASK(test_nest_fcn, test_nest, "NEST", 1);
+DEFINE_BASIC_TASK(test_nested_b2_fcn, test_nested_b2, "NB2", 2);
+DEFINE_BASIC_TASK(test_nested_b3_fcn, test_nested_b3, "NB3", 3);
+
+static rt_sem_t sem_never;
+static rt_sem_t sem_wake;
+
+static char log_text[TEST_LOG_SIZE];
+static uint32_t log_len = 0;
+static uint32_t n_errors = 0;
+
+int main(void)
+{
+  const char *expected =
+    "3" "1" "W" "b"           // B3 first, and B1 lets the waiter of higher prio in
+    "(" "3" "|" "2" ")"       // Nested from the basic task and from an ISR
+    "0";                      // BASIC at prio 0 when done
+
+  rt_init();
+
+  rt_sem_init(&sem_never, 0);
+  rt_sem_init(&sem_wake, 0);
+
+  rt_create_task(&test_main, NULL);
+  rt_create_task(&test_waiter, NULL);
+
+  rt_start();
+
+  if (strcmp(log_text, expected) != 0) {
+    printf("log \"%s\", expected \"%s\"\n", log_text, expected);
+    n_errors++;
+  }
+
+  printf("basic tasks: %u errors\n", n_errors);
+
+  return (n_errors > 0);
+}
+
+static void test_main_fcn(void *p)
+{
+  // Both pending at once, the higher prio one runs first
+  rt_activate(&test_b1);
+  rt_activate(&test_b3);
+  rt_sem_take(&sem_never, 5);
+
+  rt_activate(&test_nest);
+  rt_sem_take(&sem_never, 5);
+
+  test_log('0' + test_basic_task()->priority, 0);
+
+  rt_port_stop();
+}
+
+static void test_waiter_fcn(void *p)
+{
+  while (1) {
+    if (rt_sem_take(&sem_wake, TEST_TIMEOUT) == RT_OK)
+      test_log('W', 2);
+  }
+}
+
+void test_b1_fcn(void *p)
+{
+  test_log('1', 1);
+
+  // The waiter has higher prio than B1, so it runs before B1 continues
+  rt_sem_give(&sem_wake);
+
+  test_log('b', 1);
+}
+
+void test_b3_fcn(void *p)
+{
+  test_log('3', 3);
+}
+
+void test_nest_fcn(void *p)
+{
+  test_log('(', 1);
+
+  // Simply called
+  rt_activate(&test_nested_b3);
+
+  test_log('|', 1);
+
+  // As from an ISR, run when the ISR returns
+  rt_port_irq_active = 15;
+  rt_activate(&test_nested_b2);
+  rt_port_irq_active = 0;
+  rt_port_take_pending();
+
+  test_log(')', 1);
+}
+
+void test_nested_b2_fcn(void *p)
+{
+  test_log('2', 2);
+}
+
+void test_nested_b3_fcn(void *p)
+{
+  test_log('3', 3);
+}
+
+static void test_log(const char c, const uint32_t prio)
+{
+  // Also checks the prio of the running task
+  if (current_task->priority != prio && current_task != &test_main) {
+    printf("'%c' ran at prio %u, expected %u\n", c, current_task->priority, prio);
+    n_errors++;
+  }
+
+  if (log_len < TEST_LOG_SIZE - 1)
+    log_text[log_len++] = c;
+}
+
+static rt_task_t test_basic_task(void)
+{
+  rt_task_t task;
+
+  for (task = rt_task_list(); task != NULL; task = task->next_task) {
+    if (strcmp(task->task_name, "BASIC") == 0)
+      break;
+  }
+
+  return task;
+}
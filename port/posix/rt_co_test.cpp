@@ -0,0 +1,207 @@
+/*
+ * rt_co_test.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include <cstdio>
+
+#include "rt.hpp"
+#include "rt_co.hpp"
+
+// Test of the coroutines in rt_co.hpp on the host port, built as C++20:
+//
+//   make co
+//
+// A script activity in the executor task goes through the awaitables one
+// at a time, while a driver task of higher prio pushes, gives and signals
+// a given number of ticks later, from a task or as from an ISR. Each step
+// checks what the co_await resumed with and after how many ticks. The tick
+// is simulated, so the ticks are exact. Then child activities check that
+// their frames go back to the heap and are merged, and that a frame that
+// does not fit is refused. Returns non-zero on a mismatch.
+
+static void test_executor_fcn(void *p);
+static void test_driver_fcn(void *p);
+static void test_drive(const uint32_t ticks, void (*action)(void));
+static void test_expect(const char *what, const uint32_t value, const uint32_t expected);
+
+static rt::Task<512, 1> test_executor(test_executor_fcn, "EXECUTOR");
+static rt::Task<256, 2> test_driver(test_driver_fcn, "DRIVER");
+
+static rt::co::Executor executor;
+static rt::co::Event event(executor);
+
+static rt::Queue<uint32_t, 2> queue;
+static rt::Semaphore<> sem;
+static rt::Semaphore<> sem_drive;
+static rt::Semaphore<> sem_never;
+
+static void (*drive_action)(void);
+static uint32_t drive_ticks;
+
+static volatile uint32_t test_sink;
+static uint32_t n_errors = 0;
+
+template <size_t N>
+static rt::co::Activity test_frame(void)
+{
+  // Keeps N bytes in its frame until it is done
+  volatile uint8_t data[N];
+
+  data[0] = 1;
+  co_await rt::co::delay(1);
+  test_sink = data[0];
+}
+
+static rt::co::Activity test_script(void)
+{
+  uint32_t start, result, item;
+  size_t available;
+
+  // delay
+  start = rt_get_tick();
+  co_await rt::co::delay(10);
+  test_expect("ticks of delay(10)", rt_get_tick() - start, 10);
+
+  start = rt_get_tick();
+  co_await rt::co::yield();
+  test_expect("ticks of yield", rt_get_tick() - start, 0);
+
+  // pull, pushed by a task that notifies the executor
+  test_drive(5, [] { uint32_t value = 42; queue.push(value); executor.notify(); });
+  start = rt_get_tick();
+  result = co_await rt::co::pull(*queue.native(), &item, 100);
+  test_expect("pull", result, RT_OK);
+  test_expect("item pulled", item, 42);
+  test_expect("ticks to the pull", rt_get_tick() - start, 5);
+
+  start = rt_get_tick();
+  result = co_await rt::co::pull(*queue.native(), &item, 8);
+  test_expect("pull on timeout", result, RT_NOK);
+  test_expect("ticks to the pull timeout", rt_get_tick() - start, 8);
+
+  // push, to a full queue that a task pulls from without notifying, so
+  // it is polled
+  item = 1;
+  queue.push(item);
+  queue.push(item);
+  start = rt_get_tick();
+  result = co_await rt::co::push(*queue.native(), &item, 6);
+  test_expect("push to a full queue", result, RT_NOK);
+  test_expect("ticks to the push timeout", rt_get_tick() - start, 6);
+
+  test_drive(3, [] { uint32_t value; queue.pull(value); });
+  start = rt_get_tick();
+  result = co_await rt::co::push(*queue.native(), &item, 100);
+  test_expect("push", result, RT_OK);
+  test_expect("ticks to the push", rt_get_tick() - start, 3);
+  test_expect("items after the push", queue.items(), 2);
+
+  while (!queue.empty())
+    queue.pull(item);
+
+  // take
+  start = rt_get_tick();
+  result = co_await rt::co::take(*sem.native(), 7);
+  test_expect("take on timeout", result, RT_NOK);
+  test_expect("ticks to the take timeout", rt_get_tick() - start, 7);
+
+  test_drive(4, [] { sem.give(); });
+  start = rt_get_tick();
+  result = co_await rt::co::take(*sem.native(), 100);
+  test_expect("take", result, RT_OK);
+  test_expect("ticks to the take", rt_get_tick() - start, 4);
+
+  // wait, signalled as from an ISR
+  test_drive(3, [] {
+    rt_port_irq_active = 15;
+    event.signal_from_isr();
+    rt_port_irq_active = 0;
+    rt_port_take_pending();
+  });
+  start = rt_get_tick();
+  result = co_await rt::co::wait(event, 100);
+  test_expect("wait", result, RT_OK);
+  test_expect("ticks to the event", rt_get_tick() - start, 3);
+
+  start = rt_get_tick();
+  result = co_await rt::co::wait(event, 4);
+  test_expect("wait on timeout", result, RT_NOK);
+  test_expect("ticks to the wait timeout", rt_get_tick() - start, 4);
+
+  // Frames go back to the heap when the activities are done, and are
+  // merged so that a larger one fits in their place
+  available = rt::co::Heap::available();
+
+  for (uint32_t i = 0; i < 3; i++)
+    test_expect("spawn of a small frame", executor.spawn(test_frame<RT_CO_HEAP_SIZE / 8>()), RT_OK);
+
+  test_expect("heap in use", rt::co::Heap::available() < available - 3 * (RT_CO_HEAP_SIZE / 8), 1);
+
+  co_await rt::co::delay(2);
+  test_expect("heap when the frames are freed", rt::co::Heap::available(), available);
+
+  test_expect("spawn of a large frame", executor.spawn(test_frame<RT_CO_HEAP_SIZE / 2>()), RT_OK);
+  co_await rt::co::delay(2);
+
+  // Out of heap, which is told and leaves the heap as it was
+  test_expect("spawn of a frame too large", executor.spawn(test_frame<RT_CO_HEAP_SIZE>()), RT_NOK);
+  test_expect("heap after a failed spawn", rt::co::Heap::available(), available);
+
+  test_drive(1, rt_port_stop);
+}
+
+int main(void)
+{
+  size_t available;
+
+  rt_init();
+
+  available = rt::co::Heap::available();
+
+  executor.spawn(test_script());
+
+  test_executor.start();
+  test_driver.start();
+
+  rt_start();
+
+  // The script is done, so its frame is freed as well
+  test_expect("heap at the end", rt::co::Heap::available(), available);
+
+  printf("coroutines: %u errors\n", n_errors);
+
+  return (n_errors > 0);
+}
+
+static void test_executor_fcn(void *p)
+{
+  executor.run();
+}
+
+static void test_driver_fcn(void *p)
+{
+  while (1) {
+    sem_drive.take();
+    sem_never.take(drive_ticks);
+    drive_action();
+  }
+}
+
+static void test_drive(const uint32_t ticks, void (*action)(void))
+{
+  // Runs action in the driver task, ticks from now
+  drive_ticks = ticks;
+  drive_action = action;
+  sem_drive.give();
+}
+
+static void test_expect(const char *what, const uint32_t value, const uint32_t expected)
+{
+  if (value != expected) {
+    printf("%s: %u, expected %u\n", what, value, expected);
+    n_errors++;
+  }
+}
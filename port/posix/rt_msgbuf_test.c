@@ -0,0 +1,317 @@
+/*
+ * rt_msgbuf_test.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "rt_kernel.h"
+#include "rt_sem.h"
+#include "rt_msgbuf.h"
+
+// Test of the message buffer on the host port:
+//
+//   make msgbuf
+//
+// First a few fixed steps on a small buffer check the records: the skipped
+// end when a record does not fit before it, a reserved record that holds
+// up the ones after it, dropped and truncated messages. Then two producers,
+// one of higher and one of lower prio than the consumer, send messages of
+// random length with every send variant, and the consumer receives them by
+// copy and in place. Each message carries its producer and sequence number
+// and a pattern, which the consumer checks. Returns non-zero on a mismatch.
+
+#define TEST_TIMEOUT      (0x7FFFFFFF)
+#define TEST_MESSAGES     (2000)      // Per producer
+#define TEST_MAX_LENGTH   (60)
+#define TEST_BUFFER_SIZE  (200)
+
+static void test_main_fcn(void *p);
+static void test_producer_fcn(void *p);
+static void test_consumer_fcn(void *p);
+static void test_records(void);
+static uint32_t test_send(const uint32_t id, const uint32_t seq, uint32_t * const random);
+static void test_check_message(const uint8_t *data, const uint32_t length);
+static void test_fill(uint8_t *data, const uint32_t id, const uint32_t seq, const uint32_t length);
+static uint32_t test_random(uint32_t * const state);
+static void test_expect(const char *what, const uint32_t value, const uint32_t expected);
+
+DEFINE_TASK(test_main_fcn, test_main, "MAIN", RT_PRIO_LEVELS-1, 512);
+DEFINE_TASK(test_producer_fcn, test_producer_hi, "PROD_HI", 3, 512);
+DEFINE_TASK(test_consumer_fcn, test_consumer, "CONSUMER", 2, 512);
+DEFINE_TASK(test_producer_fcn, test_producer_lo, "PROD_LO", 1, 512);
+
+static rt_msgbuf_t mb;
+static uint32_t mb_buffer[TEST_BUFFER_SIZE / 4];
+
+static rt_sem_t sem_never;
+static rt_sem_t sem_start;
+
+static uint32_t producer_id[2] = {0, 1};
+static uint32_t next_seq[2] = {0, 0};
+static uint32_t n_errors = 0;
+
+int main(void)
+{
+  rt_init();
+
+  rt_sem_init(&sem_never, 0);
+  rt_sem_init(&sem_start, 0);
+
+  rt_create_task(&test_main, NULL);
+  rt_create_task(&test_producer_hi, &producer_id[0]);
+  rt_create_task(&test_consumer, NULL);
+  rt_create_task(&test_producer_lo, &producer_id[1]);
+
+  rt_start();
+
+  printf("message buffer: %u errors\n", n_errors);
+
+  return (n_errors > 0);
+}
+
+static void test_main_fcn(void *p)
+{
+  test_records();
+  test_expect("messages of the fixed steps", next_seq[0], 6);
+
+  // The producers and the consumer take it from here
+  rt_msgbuf_init(&mb, (uint8_t *) mb_buffer, sizeof(mb_buffer));
+  next_seq[0] = 0;
+
+  rt_sem_give(&sem_start);
+  rt_sem_give(&sem_start);
+  rt_sem_give(&sem_start);
+
+  rt_sem_take(&sem_never, TEST_TIMEOUT);
+}
+
+static void test_records(void)
+{
+  uint8_t data[20];
+  uint8_t *a, *b;
+  uint32_t length, start;
+
+  rt_msgbuf_init(&mb, (uint8_t *) mb_buffer, 64);
+
+  // Records of 24 bytes at 0, 24, and after one is received there is
+  // room at 0 but not before the end, which is skipped
+  test_fill(data, 0, 0, 20);
+  rt_msgbuf_send(&mb, data, 20, 0);
+  test_fill(data, 0, 1, 20);
+  rt_msgbuf_send(&mb, data, 20, 0);
+  test_expect("length of message 0", rt_msgbuf_receive(&mb, data, sizeof(data), 0), 20);
+  test_check_message(data, 20);
+
+  test_fill(data, 0, 2, 20);
+  test_expect("send with a skipped end", rt_msgbuf_send(&mb, data, 20, 0), RT_OK);
+  test_expect("head after the wrap", mb.head, 24);
+  test_expect("used with the skipped end", mb.used, 64);
+
+  // Full, so this one is lost
+  rt_port_irq_active = 15;
+  rt_msgbuf_send_from_isr(&mb, data, 1);
+  rt_port_irq_active = 0;
+  rt_port_take_pending();
+  test_expect("messages when full", mb.messages, 2);
+
+  test_expect("length of message 1", rt_msgbuf_receive(&mb, data, sizeof(data), 0), 20);
+  test_check_message(data, 20);
+  test_expect("tail past the skipped end", mb.tail, 0);
+  test_expect("length of message 2", rt_msgbuf_receive(&mb, data, sizeof(data), 0), 20);
+  test_check_message(data, 20);
+  test_expect("used when empty", mb.used, 0);
+
+  // A reserved record holds up the one sent after it
+  a = rt_msgbuf_send_reserve(&mb, 8, 0);
+  test_fill(data, 0, 4, 8);
+  rt_msgbuf_send(&mb, data, 8, 0);
+  test_expect("receive behind a reserved record", rt_msgbuf_receive(&mb, data, sizeof(data), 0), 0);
+  test_fill(a, 0, 3, 8);
+  rt_msgbuf_send_commit(&mb, a, 8);
+  test_expect("length of message 3", rt_msgbuf_receive(&mb, data, sizeof(data), 0), 8);
+  test_check_message(data, 8);
+  test_expect("length of message 4", rt_msgbuf_receive(&mb, data, sizeof(data), 0), 8);
+  test_check_message(data, 8);
+
+  // Dropped, by length 0 or a length longer than reserved, and freed
+  // along with what is before them
+  a = rt_msgbuf_send_reserve(&mb, 8, 0);
+  b = rt_msgbuf_send_reserve(&mb, 8, 0);
+  rt_msgbuf_send_commit(&mb, b, 12);
+  rt_msgbuf_send_commit(&mb, a, 0);
+  test_expect("messages after drops", mb.messages, 0);
+  test_expect("used after drops", mb.used, 0);
+
+  // Longer than max_length, the length is told but not all is copied
+  test_fill(data, 0, 5, 20);
+  rt_msgbuf_send(&mb, data, 20, 0);
+  memset(data, 0, sizeof(data));
+  test_expect("length when truncated", rt_msgbuf_receive(&mb, data, 3, 0), 20);
+  test_check_message(data, 3);
+  test_expect("byte after the truncation", data[3], 0);
+
+  // Nothing to receive within the timeout
+  start = rt_get_tick();
+  test_expect("receive_reserve on timeout", rt_msgbuf_receive_reserve(&mb, &length, 5) == NULL, 1);
+  test_expect("ticks to the timeout", rt_get_tick() - start, 5);
+
+  // Too large for the buffer at all
+  test_expect("reserve larger than the buffer", rt_msgbuf_send_reserve(&mb, 61, 0) == NULL, 1);
+}
+
+static void test_producer_fcn(void *p)
+{
+  const uint32_t id = *((uint32_t *) p);
+  uint32_t random = id + 1;
+  uint32_t seq = 0;
+
+  rt_sem_take(&sem_start, TEST_TIMEOUT);
+
+  while (seq < TEST_MESSAGES) {
+    if (test_send(id, seq, &random) == RT_OK)
+      seq++;
+  }
+
+  rt_sem_take(&sem_never, TEST_TIMEOUT);
+}
+
+static uint32_t test_send(const uint32_t id, const uint32_t seq, uint32_t * const random)
+{
+  // RT_OK if message seq was sent
+  uint8_t data[TEST_MAX_LENGTH];
+  uint8_t *p;
+  uint32_t length = 3 + test_random(random) % (TEST_MAX_LENGTH - 2);
+  uint32_t messages, sent;
+
+  switch (test_random(random) % 5) {
+
+  case 0:
+    test_fill(data, id, seq, length);
+    return rt_msgbuf_send(&mb, data, length, TEST_TIMEOUT);
+
+  case 1:
+    // As from an ISR, which only tells if a task was unblocked
+    test_fill(data, id, seq, length);
+    rt_enter_critical();
+    messages = mb.messages;
+    rt_port_irq_active = 15;
+    if (rt_msgbuf_send_from_isr(&mb, data, length) != RT_NOK)
+      rt_pend_yield();
+    rt_port_irq_active = 0;
+    sent = (mb.messages != messages);
+    rt_exit_critical();
+    rt_port_take_pending();
+
+    // Full, let the consumer catch up
+    if (!sent)
+      rt_sem_take(&sem_never, 1);
+
+    return sent ? RT_OK : RT_NOK;
+
+  case 2:
+    // Reserved for more than what is sent
+    p = rt_msgbuf_send_reserve(&mb, TEST_MAX_LENGTH, TEST_TIMEOUT);
+    test_fill(p, id, seq, length);
+    rt_msgbuf_send_commit(&mb, p, length);
+    return RT_OK;
+
+  case 3:
+    p = rt_msgbuf_send_reserve(&mb, length, TEST_TIMEOUT);
+    test_fill(p, id, seq, length);
+    rt_msgbuf_send_commit(&mb, p, length);
+    return RT_OK;
+
+  default:
+    // Dropped, so seq is sent next time
+    p = rt_msgbuf_send_reserve(&mb, length, TEST_TIMEOUT);
+    rt_msgbuf_send_commit(&mb, p, 0);
+    return RT_NOK;
+  }
+}
+
+static void test_consumer_fcn(void *p)
+{
+  uint8_t data[TEST_MAX_LENGTH];
+  uint8_t *message;
+  uint32_t length;
+  uint32_t received = 0;
+  uint32_t random = 3;
+
+  rt_sem_take(&sem_start, TEST_TIMEOUT);
+
+  while (received < 2 * TEST_MESSAGES) {
+    if (test_random(&random) & 1) {
+      length = rt_msgbuf_receive(&mb, data, sizeof(data), TEST_TIMEOUT);
+      test_check_message(data, length);
+    } else {
+      message = rt_msgbuf_receive_reserve(&mb, &length, TEST_TIMEOUT);
+      test_check_message(message, length);
+      rt_msgbuf_receive_release(&mb);
+    }
+    received++;
+  }
+
+  test_expect("messages of producer 0", next_seq[0], TEST_MESSAGES);
+  test_expect("messages of producer 1", next_seq[1], TEST_MESSAGES);
+  test_expect("messages left", mb.messages, 0);
+  test_expect("used when done", mb.used, 0);
+
+  rt_port_stop();
+}
+
+static void test_check_message(const uint8_t *data, const uint32_t length)
+{
+  // The producer and seq are in the first 3 bytes, then the pattern
+  uint32_t id = data[0];
+  uint32_t seq = data[1] | (data[2] << 8);
+  uint32_t k;
+
+  if (length < 3 || id > 1 || seq != next_seq[id]) {
+    printf("message of length %u from %u, seq %u\n", length, id, seq);
+    n_errors++;
+    return;
+  }
+
+  next_seq[id]++;
+
+  for (k = 3; k < length; k++) {
+    if (data[k] != (uint8_t) (seq * 7 + k + id)) {
+      printf("message %u from %u: byte %u is %u\n", seq, id, k, data[k]);
+      n_errors++;
+      return;
+    }
+  }
+}
+
+static void test_fill(uint8_t *data, const uint32_t id, const uint32_t seq, const uint32_t length)
+{
+  uint32_t k;
+
+  data[0] = id;
+  data[1] = seq;
+  data[2] = seq >> 8;
+
+  for (k = 3; k < length; k++)
+    data[k] = (uint8_t) (seq * 7 + k + id);
+}
+
+static uint32_t test_random(uint32_t * const state)
+{
+  // xorshift, the same sequence every run
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+static void test_expect(const char *what, const uint32_t value, const uint32_t expected)
+{
+  if (value != expected) {
+    printf("%s: %u, expected %u\n", what, value, expected);
+    n_errors++;
+  }
+}
@@ -0,0 +1,297 @@
+/*
+ * rt_port.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "rt_kernel.h"
+#include "rt_port.h"
+
+typedef struct {
+  ucontext_t context;
+  void (*code)(void *);
+  void *parameters;
+  void (*nest_code)(const uint32_t);  // See rt_port_nest
+  uint32_t nest_parameter;
+} rt_port_context_t;
+
+static void rt_port_task_entry(void);
+static void rt_port_systick(void);
+static void rt_port_switch(void);
+static void rt_port_sigalrm(int sig);
+#if RT_BASIC_ENABLE
+static void rt_port_run_nested(void);
+#endif
+
+// Interrupts stay disabled until rt_port_start, like before rt_start on the target
+volatile sig_atomic_t rt_port_irq_masked = 0;
+volatile sig_atomic_t rt_port_irq_disabled = 1;
+volatile sig_atomic_t rt_port_irq_active = 0;   // Exception number of the running "ISR"
+volatile sig_atomic_t rt_port_pending = 0;      // Something to do for rt_port_dispatch
+volatile sig_atomic_t rt_port_yield_pending = 0;
+
+static uint32_t ticks_pending = 0;              // Atomic, also written by the SIGALRM handler
+static uint32_t switch_count = 0;
+static ucontext_t main_context;
+
+volatile uint64_t rt_port_virtual_ns = 0;
+static uint64_t next_tick_ns = RT_PORT_TICK_NS;
+static uint64_t stop_ns = UINT64_MAX;
+
+void rt_port_init(void)
+{
+}
+
+void * rt_port_init_stack(rt_task_t const task, void * const task_parameters)
+{
+  rt_port_context_t *context = malloc(sizeof(rt_port_context_t));
+  uint32_t *stack = malloc(RT_PORT_STACK_SIZE);
+  uint32_t i;
+
+  if (context == NULL || stack == NULL) {
+    free(context);
+    free(stack);
+    return NULL;
+  }
+
+  // A stack sized for the target is far too small for host code, so the
+  // task gets a new one. The high water mark then applies to that stack.
+  task->stack_start = stack;
+  task->stack_size = RT_PORT_STACK_SIZE / sizeof(uint32_t);
+
+  for (i = 0; i < task->stack_size; i++)
+    stack[i] = RT_STACK_FILL_PATTERN;
+
+  context->code = (void (*)(void *)) task->code_start;
+  context->parameters = task_parameters;
+  context->nest_code = NULL;
+
+  getcontext(&(context->context));
+  context->context.uc_stack.ss_sp = stack;
+  context->context.uc_stack.ss_size = RT_PORT_STACK_SIZE;
+  context->context.uc_link = NULL;
+  sigemptyset(&(context->context.uc_sigmask));
+  makecontext(&(context->context), rt_port_task_entry, 0);
+
+  return context;
+}
+
+void rt_port_start(void)
+{
+  rt_port_context_t *first = (rt_port_context_t *) current_task->sp;
+  struct sigaction action;
+  struct itimerval timer;
+
+  if (RT_PORT_TICK_US > 0) {
+    action.sa_handler = rt_port_sigalrm;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGALRM, &action, NULL);
+
+    timer.it_interval.tv_sec = RT_PORT_TICK_US / 1000000;
+    timer.it_interval.tv_usec = RT_PORT_TICK_US % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, NULL);
+  }
+
+  // Yields pended while creating tasks are moot, the first task is picked already
+  rt_port_yield_pending = 0;
+  rt_port_irq_masked = 0;
+  rt_port_irq_disabled = 0;
+  rt_port_irq_active = RT_PORT_SVC_IRQ;
+
+  swapcontext(&main_context, &(first->context));
+
+  // Back from rt_port_stop
+}
+
+void rt_port_stop(void)
+{
+  // Makes rt_start return to its caller
+  rt_port_context_t *context = (rt_port_context_t *) current_task->sp;
+  struct itimerval timer = {{0, 0}, {0, 0}};
+
+  setitimer(ITIMER_REAL, &timer, NULL);
+
+  rt_port_irq_disabled = 1;
+
+  swapcontext(&(context->context), &main_context);
+}
+
+void rt_port_tick(void)
+{
+  // Raise the tick interrupt, taken right away unless masked
+  __atomic_add_fetch(&ticks_pending, 1, __ATOMIC_SEQ_CST);
+  rt_port_pending = 1;
+  rt_port_dispatch();
+}
+
+void rt_port_idle(void)
+{
+  if (RT_PORT_TICK_US > 0) {
+    pause();
+  } else if (next_wakeup_tick == RT_FOREVER_TICK) {
+    // Every task is blocked without a timeout and nothing else can happen
+    rt_port_stop();
+  } else if (RT_PORT_VIRTUAL_TIME) {
+    rt_port_advance(next_tick_ns - rt_port_virtual_ns);
+  } else {
+    // Nothing else to run, so skip ahead to the next tick
+    rt_port_tick();
+  }
+}
+
+void rt_port_advance(uint32_t ns)
+{
+  // Let the running task consume virtual time. The ticks on the way may
+  // switch to other tasks, which then consume their own time before this
+  // one gets to continue.
+  uint64_t step;
+
+  while (ns > 0) {
+    step = next_tick_ns - rt_port_virtual_ns;
+    if (step > ns)
+      step = ns;
+
+    rt_port_virtual_ns += step;
+    ns -= step;
+
+    if (rt_port_virtual_ns == next_tick_ns) {
+      next_tick_ns += RT_PORT_TICK_NS;
+
+      if (rt_port_virtual_ns >= stop_ns)
+        rt_port_stop();
+
+      rt_port_tick();
+    }
+  }
+}
+
+void rt_port_stop_at(const uint64_t ns)
+{
+  // rt_start returns when the virtual time gets to ns
+  stop_ns = ns;
+}
+
+uint32_t rt_port_switch_count(void)
+{
+  return switch_count;
+}
+
+void rt_port_dispatch(void)
+{
+  // Whatever the target would take when unmasked: the tick first, then
+  // PendSV which has the lowest prio. A signal may arrive at any point,
+  // so the pending flag is cleared before looking at what is pending.
+  uint32_t ticks;
+
+  while (rt_port_pending && !rt_port_irq_masked && !rt_port_irq_disabled && !rt_port_irq_active) {
+    rt_port_pending = 0;
+
+    for (ticks = __atomic_exchange_n(&ticks_pending, 0, __ATOMIC_SEQ_CST); ticks > 0; ticks--)
+      rt_port_systick();
+
+    if (rt_port_yield_pending) {
+      rt_port_yield_pending = 0;
+      rt_port_switch();
+    }
+  }
+}
+
+static void rt_port_systick(void)
+{
+  rt_port_irq_active = RT_PORT_SYSTICK_IRQ;
+
+  RT_TRACE_ISR_ENTER();
+
+  rt_mask_irq();
+
+  if (RT_OK==rt_increment_tick())
+    rt_pend_yield();
+
+  rt_unmask_irq();
+
+  RT_TRACE_ISR_EXIT();
+
+  rt_port_irq_active = 0;
+}
+
+static void rt_port_switch(void)
+{
+  rt_port_context_t *from, *to;
+
+  // Acts as PendSV until the next task is running, so that a tick in
+  // between can not switch away from a half saved context
+  rt_port_irq_active = RT_PORT_PENDSV_IRQ;
+
+  from = (rt_port_context_t *) current_task->sp;
+  rt_switch_task();
+  to = (rt_port_context_t *) current_task->sp;
+
+  if (to != from) {
+    switch_count++;
+    swapcontext(&(from->context), &(to->context));
+  }
+
+#if RT_BASIC_ENABLE
+  rt_port_run_nested();
+#endif
+
+  rt_port_irq_active = 0;
+}
+
+#if RT_BASIC_ENABLE
+void rt_port_nest(rt_task_t const task, void (*code)(const uint32_t), const uint32_t parameter)
+{
+  // Called by rt_switch_task. The task was switched out from within
+  // rt_port_switch, so that is where it continues and calls code.
+  rt_port_context_t *context = (rt_port_context_t *) task->sp;
+
+  context->nest_code = code;
+  context->nest_parameter = parameter;
+}
+
+static void rt_port_run_nested(void)
+{
+  // Running on the stack of the task that was switched to, on top of
+  // where it was interrupted
+  rt_port_context_t *context = (rt_port_context_t *) current_task->sp;
+  void (*code)(const uint32_t);
+
+  while ((code = context->nest_code) != NULL) {
+    context->nest_code = NULL;
+
+    rt_port_irq_active = 0;
+    code(context->nest_parameter);
+    rt_port_irq_active = RT_PORT_PENDSV_IRQ;
+  }
+}
+#endif
+
+static void rt_port_task_entry(void)
+{
+  rt_port_context_t *context = (rt_port_context_t *) current_task->sp;
+
+  // Started from rt_port_start or rt_port_switch
+  rt_port_irq_active = 0;
+  rt_port_take_pending();
+
+  context->code(context->parameters);
+
+  // Tasks must not return, on the target it ends in a fault
+  rt_port_stop();
+}
+
+static void rt_port_sigalrm(int sig)
+{
+  (void) sig;
+
+  rt_port_tick();
+}
@@ -0,0 +1,162 @@
+/*
+ * rt_port.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_PORT_H_
+#define RT_PORT_H_
+
+#include <signal.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "rt_kernel_defs.h"
+
+// POSIX host port, see port/posix/Makefile. Every task runs on its own
+// ucontext in a single process. Interrupt masking is emulated with flags,
+// and the tick and pended yields are held back until unmasked just like
+// SysTick and PendSV on the target.
+//
+// With RT_PORT_TICK_US set to 0 the tick is simulated: time only advances
+// when the idle task runs, so a task that never blocks is not preempted
+// by the tick. Otherwise SIGALRM drives the tick with that period.
+//
+// RT_PORT_VIRTUAL_TIME adds a virtual clock to the simulated tick. Tasks
+// consume virtual time with rt_port_advance (see rt_sim.h), idle skips to
+// the next tick, and rt_get_cycles reads the virtual clock. Runs are then
+// fully deterministic.
+
+#ifndef RT_PORT_TICK_US
+#define RT_PORT_TICK_US         (0)
+#endif
+
+#ifndef RT_PORT_VIRTUAL_TIME
+#define RT_PORT_VIRTUAL_TIME    (0)
+#endif
+#define RT_PORT_TICK_NS         (1000000)   // Virtual time between ticks
+
+#if RT_TRACE_ITM_ENABLE
+#error "There is no ITM on the host, use rt_trace_read"
+#endif
+
+#if RT_STATIC_IMAGE_ENABLE
+#error "Host tasks are threads that rt_create_task has to start"
+#endif
+
+#if RT_PORT_VIRTUAL_TIME && RT_PORT_TICK_US
+#error "RT_PORT_VIRTUAL_TIME needs the simulated tick, RT_PORT_TICK_US 0"
+#endif
+
+#ifndef RT_PORT_STACK_SIZE
+#define RT_PORT_STACK_SIZE      (16*1024)   // Bytes, replaces the task's own stack
+#endif
+
+#define RT_PORT_CYCLES_HZ       (1000000000) // rt_get_cycles counts nanoseconds, real or virtual
+
+// Exception numbers as on the target, for rt_port_active_irq
+#define RT_PORT_SVC_IRQ         (11)
+#define RT_PORT_PENDSV_IRQ      (14)
+#define RT_PORT_SYSTICK_IRQ     (15)
+
+void rt_port_init(void);
+void * rt_port_init_stack(rt_task_t const task, void * const task_parameters);
+void rt_port_start(void);
+void rt_port_stop(void);
+void rt_port_tick(void);
+void rt_port_idle(void);
+void rt_port_dispatch(void);
+uint32_t rt_port_switch_count(void);
+void rt_port_advance(uint32_t ns);
+void rt_port_stop_at(const uint64_t ns);
+void rt_port_nest(rt_task_t const task, void (*code)(const uint32_t), const uint32_t parameter);
+
+extern volatile uint64_t rt_port_virtual_ns;
+
+extern volatile sig_atomic_t rt_port_irq_masked;
+extern volatile sig_atomic_t rt_port_irq_disabled;
+extern volatile sig_atomic_t rt_port_irq_active;
+extern volatile sig_atomic_t rt_port_pending;
+extern volatile sig_atomic_t rt_port_yield_pending;
+
+#define rt_port_barrier()       __asm volatile ("" ::: "memory")
+
+ALWAYS_INLINE static void rt_port_take_pending(void)
+{
+  if (rt_port_pending)
+    rt_port_dispatch();
+}
+
+ALWAYS_INLINE static void rt_pend_yield()
+{
+  rt_port_yield_pending = 1;
+  rt_port_pending = 1;
+  rt_port_take_pending();
+}
+
+ALWAYS_INLINE static uint32_t rt_get_cycles(void)
+{
+#if RT_PORT_VIRTUAL_TIME
+  return (uint32_t) rt_port_virtual_ns;
+#else
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint32_t) (now.tv_sec * RT_PORT_CYCLES_HZ + now.tv_nsec);
+#endif
+}
+
+ALWAYS_INLINE static void rt_enable_irq(void)
+{
+  rt_port_barrier();
+  rt_port_irq_disabled = 0;
+  rt_port_take_pending();
+}
+
+ALWAYS_INLINE static void rt_disable_irq(void)
+{
+  rt_port_irq_disabled = 1;
+  rt_port_barrier();
+}
+
+ALWAYS_INLINE static void rt_mask_irq(void)
+{
+  rt_port_irq_masked = 1;
+  rt_port_barrier();
+}
+
+ALWAYS_INLINE static void rt_unmask_irq(void)
+{
+  rt_port_barrier();
+  rt_port_irq_masked = 0;
+  rt_port_take_pending();
+}
+
+ALWAYS_INLINE static uint32_t rt_port_irq_save(void)
+{
+  uint32_t disabled = rt_port_irq_disabled;
+  rt_port_irq_disabled = 1;
+  rt_port_barrier();
+  return disabled;
+}
+
+ALWAYS_INLINE static void rt_port_irq_restore(const uint32_t disabled)
+{
+  rt_port_barrier();
+  rt_port_irq_disabled = disabled;
+  rt_port_take_pending();
+}
+
+ALWAYS_INLINE static uint32_t rt_port_active_irq(void)
+{
+  return rt_port_irq_active;
+}
+
+ALWAYS_INLINE static void rt_port_task_switched(rt_task_t const task)
+{
+  (void) task;
+}
+
+#endif /* RT_PORT_H_ */
@@ -0,0 +1,187 @@
+/*
+ * rt_queue_test.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include <stdio.h>
+
+#include "rt_kernel.h"
+#include "rt_sem.h"
+#include "rt_queue.h"
+
+// Test of the queue wake thresholds on the host port:
+//
+//   make queue
+//
+// The main task pulls while a pusher of lower prio pushes a number of
+// bytes every few ticks, from a task or as from an ISR. Each case checks
+// how many bytes were pulled, after how many ticks, and that they came in
+// order. The tick is simulated, so the ticks are exact. Returns non-zero
+// on a mismatch.
+
+#define TEST_TIMEOUT    (0x7FFFFFFF)
+#define TEST_QUEUE_SIZE (32)
+
+typedef struct {
+  const char *name;
+  uint32_t threshold;
+  uint32_t max_items;             // 0 for rt_queue_pull
+  uint32_t timeout;
+  uint32_t pushes;                // Of push_items each, every push_delay ticks
+  uint32_t push_items;
+  uint32_t push_delay;
+  uint32_t from_isr;
+  uint32_t expect_items;
+  uint32_t expect_ticks;
+} test_case_t;
+
+static const test_case_t test_cases[] = {
+  // name                 thr  max   tmo  n  items  delay  isr  items  ticks
+  {"fewer than threshold", 16,   4, 1000, 1,     8,     5,   0,     4,     5},
+  {"fewer from isr",       16,   4, 1000, 1,     8,     5,   1,     4,     5},
+  {"threshold",            16,  32, 1000, 2,     8,     5,   0,    16,    10},
+  {"threshold from isr",   16,  32, 1000, 2,     8,     5,   1,    16,    10},
+  {"timeout",              16,  32,   50, 1,     4,     5,   0,     4,    50},
+  {"single at threshold",  16,   0, 1000, 2,     8,     5,   0,     1,    10},
+  {"default threshold",     1,  32, 1000, 1,     3,     5,   0,     3,     5},
+};
+
+#define TEST_N_CASES (sizeof(test_cases) / sizeof(test_cases[0]))
+
+static void test_main_fcn(void *p);
+static void test_pusher_fcn(void *p);
+static void test_check(const test_case_t *c, const uint8_t *items, const uint32_t n, const uint32_t ticks);
+static void test_drain(void);
+
+DEFINE_TASK(test_main_fcn, test_main, "MAIN", RT_PRIO_LEVELS-1, 256);
+DEFINE_TASK(test_pusher_fcn, test_pusher, "PUSHER", 1, 256);
+
+static rt_queue_t queue;
+static uint8_t queue_buffer[TEST_QUEUE_SIZE];
+
+static rt_sem_t sem_never;
+static rt_sem_t sem_start;
+static rt_sem_t sem_done;
+
+static const test_case_t * volatile test_case;
+static uint8_t next_pushed = 0;
+static uint8_t next_pulled = 0;
+static uint32_t n_errors = 0;
+
+int main(void)
+{
+  rt_init();
+
+  rt_queue_init(&queue, queue_buffer, 1, TEST_QUEUE_SIZE);
+
+  rt_sem_init(&sem_never, 0);
+  rt_sem_init(&sem_start, 0);
+  rt_sem_init(&sem_done, 0);
+
+  rt_create_task(&test_main, NULL);
+  rt_create_task(&test_pusher, NULL);
+
+  rt_start();
+
+  printf("queue thresholds: %u errors\n", n_errors);
+
+  return (n_errors > 0);
+}
+
+static void test_main_fcn(void *p)
+{
+  uint8_t items[TEST_QUEUE_SIZE];
+  uint32_t i, n, start;
+
+  for (i = 0; i < TEST_N_CASES; i++) {
+    const test_case_t *c = &test_cases[i];
+
+    rt_queue_set_threshold(&queue, c->threshold);
+
+    test_case = c;
+    rt_sem_give(&sem_start);
+
+    start = rt_get_tick();
+
+    if (c->max_items > 0)
+      n = rt_queue_pull_n(&queue, items, c->max_items, c->timeout);
+    else
+      n = (rt_queue_pull(&queue, items, c->timeout) == RT_OK);
+
+    test_check(c, items, n, rt_get_tick() - start);
+
+    // Let the pusher finish, and start over with an empty queue
+    rt_sem_take(&sem_done, TEST_TIMEOUT);
+    test_drain();
+  }
+
+  rt_port_stop();
+}
+
+static void test_pusher_fcn(void *p)
+{
+  uint8_t items[TEST_QUEUE_SIZE];
+  uint32_t i, k, pushed;
+
+  while (1) {
+    rt_sem_take(&sem_start, TEST_TIMEOUT);
+
+    const test_case_t *c = test_case;
+
+    for (i = 0; i < c->pushes; i++) {
+      rt_sem_take(&sem_never, c->push_delay);
+
+      for (k = 0; k < c->push_items; k++)
+        items[k] = next_pushed++;
+
+      if (c->from_isr) {
+        rt_port_irq_active = 15;
+        if (rt_queue_push_n_from_isr(&queue, items, c->push_items, &pushed) != RT_NOK)
+          rt_pend_yield();
+        rt_port_irq_active = 0;
+        rt_port_take_pending();
+      } else {
+        pushed = rt_queue_push_n(&queue, items, c->push_items, 0);
+      }
+
+      if (pushed != c->push_items) {
+        printf("%s: pushed %u of %u\n", c->name, pushed, c->push_items);
+        n_errors++;
+      }
+    }
+
+    rt_sem_give(&sem_done);
+  }
+}
+
+static void test_check(const test_case_t *c, const uint8_t *items, const uint32_t n, const uint32_t ticks)
+{
+  uint32_t i;
+
+  if (n != c->expect_items || ticks != c->expect_ticks) {
+    printf("%s: %u items after %u ticks, expected %u after %u\n",
+           c->name, n, ticks, c->expect_items, c->expect_ticks);
+    n_errors++;
+  }
+
+  for (i = 0; i < n; i++) {
+    if (items[i] != next_pulled) {
+      printf("%s: pulled %u, expected %u\n", c->name, items[i], next_pulled);
+      n_errors++;
+      next_pulled = items[i];
+    }
+    next_pulled++;
+  }
+}
+
+static void test_drain(void)
+{
+  uint8_t items[TEST_QUEUE_SIZE];
+  uint32_t pulled;
+
+  rt_queue_pull_n_from_isr(&queue, items, TEST_QUEUE_SIZE, &pulled);
+
+  next_pulled += pulled;
+}
@@ -0,0 +1,160 @@
+/*
+ * rt_sim.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_sim.h"
+#include "rt_sem.h"
+
+static void rt_sim_periodic_fcn(void *p);
+static void rt_sim_record(rt_sim_task_t *task, const uint64_t response_ns);
+
+static uint32_t random_state = 1;
+static rt_sim_task_t *sim_task_list = NULL;
+static rt_sem_t sem_never;
+static uint32_t sem_never_init = 0;
+
+void rt_sim_seed(const uint32_t seed)
+{
+  // xorshift32 must not start at zero
+  random_state = (seed != 0) ? seed : 1;
+}
+
+static uint32_t rt_sim_random(void)
+{
+  uint32_t x = random_state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+
+  return (random_state = x);
+}
+
+uint32_t rt_sim_draw(const rt_sim_exec_t *exec)
+{
+  switch (exec->model) {
+    case RT_SIM_EXEC_UNIFORM:
+      if (exec->max_ns <= exec->min_ns)
+        return exec->min_ns;
+      return exec->min_ns + rt_sim_random() % (exec->max_ns - exec->min_ns + 1);
+
+    case RT_SIM_EXEC_SAMPLES:
+      if (exec->n_samples == 0)
+        return 0;
+      return exec->samples[rt_sim_random() % exec->n_samples];
+
+    default:
+      return exec->min_ns;
+  }
+}
+
+uint32_t rt_sim_execute(const rt_sim_exec_t *exec)
+{
+  // Returns the execution time, excluding any preemption
+  uint32_t ns = rt_sim_draw(exec);
+
+  rt_port_advance(ns);
+
+  return ns;
+}
+
+uint32_t rt_sim_create_task(rt_sim_task_t *task)
+{
+  if (!sem_never_init) {
+    rt_sem_init(&sem_never, 0);
+    sem_never_init = 1;
+  }
+
+  task->tcb.code_start = (void *) rt_sim_periodic_fcn;
+  task->response_min_ns = UINT64_MAX;
+
+  if (rt_create_task(&(task->tcb), task) != RT_OK)
+    return RT_NOK;
+
+  task->next_sim_task = sim_task_list;
+  sim_task_list = task;
+
+  return RT_OK;
+}
+
+void rt_sim_run(const uint64_t duration_ns)
+{
+  // Returns when the virtual time is up
+  rt_port_stop_at(rt_port_virtual_ns + duration_ns);
+  rt_start();
+}
+
+static void rt_sim_periodic_fcn(void *p)
+{
+  rt_sim_task_t *task = (rt_sim_task_t *) p;
+  uint32_t release = task->offset;
+  uint64_t release_ns;
+
+  while (1) {
+    // A job that finished late releases the next one right away
+    if (release > rt_get_tick())
+      rt_sem_take(&sem_never, release - rt_get_tick());
+
+    // Tick n happens at n*RT_PORT_TICK_NS
+    release_ns = (uint64_t) release * RT_PORT_TICK_NS;
+
+    rt_sim_execute(&(task->exec));
+
+    rt_sim_record(task, rt_port_virtual_ns - release_ns);
+
+    release += task->tcb.timing.period;
+  }
+}
+
+static void rt_sim_record(rt_sim_task_t *task, const uint64_t response_ns)
+{
+  uint64_t us = response_ns / 1000;
+  uint32_t bucket = (us > 1) ? 63 - __builtin_clzll(us) : 0;
+
+  if (bucket >= RT_SIM_HIST_BUCKETS)
+    bucket = RT_SIM_HIST_BUCKETS - 1;
+
+  task->jobs++;
+  task->histogram[bucket]++;
+  task->response_sum_ns += response_ns;
+
+  if (response_ns < task->response_min_ns)
+    task->response_min_ns = response_ns;
+  if (response_ns > task->response_max_ns)
+    task->response_max_ns = response_ns;
+
+  if (response_ns > (uint64_t) task->tcb.timing.deadline * RT_PORT_TICK_NS)
+    task->deadline_misses++;
+}
+
+void rt_sim_report(FILE *out)
+{
+  rt_sim_task_t *task;
+  uint32_t i;
+
+  fprintf(out, "%.3f s simulated, %u ticks, %u context switches\n",
+          rt_port_virtual_ns / 1e9, rt_get_tick(), rt_port_switch_count());
+  fprintf(out, "%-12s %4s %6s %8s %10s %8s %10s %10s %10s\n",
+          "task", "prio", "period", "deadline", "jobs", "misses", "min_us", "mean_us", "max_us");
+
+  for (task = sim_task_list; task != NULL; task = task->next_sim_task) {
+    fprintf(out, "%-12s %4u %6u %8u %10u %8u %10.1f %10.1f %10.1f\n",
+            task->tcb.task_name, task->tcb.base_prio, task->tcb.timing.period, task->tcb.timing.deadline,
+            task->jobs, task->deadline_misses,
+            (task->jobs > 0) ? task->response_min_ns / 1e3 : 0.0,
+            (task->jobs > 0) ? task->response_sum_ns / 1e3 / task->jobs : 0.0,
+            task->response_max_ns / 1e3);
+  }
+
+  for (task = sim_task_list; task != NULL; task = task->next_sim_task) {
+    fprintf(out, "\n%s response time histogram:\n", task->tcb.task_name);
+
+    for (i = 0; i < RT_SIM_HIST_BUCKETS; i++) {
+      if (task->histogram[i] > 0)
+        fprintf(out, "  %8u - %8u us %10u\n", (i > 0) ? (1U << i) : 0, (1U << (i+1)) - 1, task->histogram[i]);
+    }
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * rt_sim.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#ifndef RT_SIM_H_
+#define RT_SIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "rt_kernel.h"
+
+// Discrete event simulation of a task set on the host port, built with
+// RT_PORT_VIRTUAL_TIME set. Task bodies do not burn real cycles but draw an
+// execution time from a model and consume it as virtual time, during which
+// the ticks may preempt them as usual. Hours of operation run in seconds
+// and every run with the same seed gives the same result.
+//
+// Periodic tasks are described by rt_sim_task_t and get their response
+// time and deadline misses recorded. Other task bodies may call
+// rt_sim_execute directly.
+
+#if !RT_PORT_VIRTUAL_TIME
+#error "rt_sim needs RT_PORT_VIRTUAL_TIME"
+#endif
+
+#define RT_SIM_HIST_BUCKETS     (24)  // Bucket i > 0 counts response times in [2^i, 2^(i+1)) us
+
+enum {
+  RT_SIM_EXEC_FIXED = 0,
+  RT_SIM_EXEC_UNIFORM,
+  RT_SIM_EXEC_SAMPLES
+};
+
+typedef struct {
+  uint32_t model;
+  uint32_t min_ns;              // Fixed: the execution time
+  uint32_t max_ns;
+  const uint32_t *samples;      // Measured execution times, drawn with equal probability
+  uint32_t n_samples;
+} rt_sim_exec_t;
+
+#define RT_SIM_EXEC_FIXED_INIT(ns)              {RT_SIM_EXEC_FIXED, (ns), (ns), NULL, 0}
+#define RT_SIM_EXEC_UNIFORM_INIT(min, max)      {RT_SIM_EXEC_UNIFORM, (min), (max), NULL, 0}
+#define RT_SIM_EXEC_SAMPLES_INIT(samples, n)    {RT_SIM_EXEC_SAMPLES, 0, 0, (samples), (n)}
+
+typedef struct rt_sim_task {
+  rt_tcb_t tcb;                 // Period and deadline in tcb.timing
+  uint32_t offset;              // Tick of the first release
+  rt_sim_exec_t exec;
+
+  uint32_t jobs;
+  uint32_t deadline_misses;
+  uint64_t response_min_ns;
+  uint64_t response_max_ns;
+  uint64_t response_sum_ns;
+  uint32_t histogram[RT_SIM_HIST_BUCKETS];
+  struct rt_sim_task *next_sim_task;
+} rt_sim_task_t;
+
+#define RT_SIM_TASK_INIT(name, prio, period, deadline, offset, exec) \
+  {TCB_INIT_TIMING(NULL, NULL, name, prio, 0, period, deadline, 0, 0), offset, exec, 0, 0, 0, 0, 0, {0}, NULL}
+
+void rt_sim_seed(const uint32_t seed);
+uint32_t rt_sim_draw(const rt_sim_exec_t *exec);
+uint32_t rt_sim_execute(const rt_sim_exec_t *exec);
+uint32_t rt_sim_create_task(rt_sim_task_t *task);
+void rt_sim_run(const uint64_t duration_ns);
+void rt_sim_report(FILE *out);
+
+#endif /* RT_SIM_H_ */
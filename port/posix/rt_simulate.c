@@ -0,0 +1,46 @@
+/*
+ * rt_simulate.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include <stdlib.h>
+
+#include "rt_sim.h"
+
+// Example task set for the virtual time simulation:
+//
+//   rt_simulate [seconds] [seed]
+//
+// Edit the task set below to try out prios and periods. Execution times
+// are in ns, periods and deadlines in ticks.
+
+static const uint32_t log_samples[] = {
+  // E.g. taken from the micro benchmarks or a trace of the real task
+  180000, 190000, 185000, 210000, 195000, 640000, 200000, 188000
+};
+
+static rt_sim_task_t control = RT_SIM_TASK_INIT("CONTROL", 3, 1, 1, 0, RT_SIM_EXEC_FIXED_INIT(150000));
+static rt_sim_task_t comms = RT_SIM_TASK_INIT("COMMS", 2, 5, 5, 1, RT_SIM_EXEC_UNIFORM_INIT(400000, 1900000));
+static rt_sim_task_t logger = RT_SIM_TASK_INIT("LOG", 1, 4, 10, 2, RT_SIM_EXEC_SAMPLES_INIT(log_samples, sizeof(log_samples)/sizeof(log_samples[0])));
+
+int main(int argc, char *argv[])
+{
+  uint32_t seconds = (argc > 1) ? strtoul(argv[1], NULL, 0) : 3600;
+  uint32_t seed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+
+  rt_init();
+
+  rt_sim_seed(seed);
+
+  rt_sim_create_task(&control);
+  rt_sim_create_task(&comms);
+  rt_sim_create_task(&logger);
+
+  rt_sim_run((uint64_t) seconds * 1000000000);
+
+  rt_sim_report(stdout);
+
+  return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * rt_stress.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "rt_kernel.h"
+#include "rt_sem.h"
+#include "rt_queue.h"
+
+// Scheduler stress test for the host port:
+//
+//   rt_stress [tasks] [ticks]
+//
+// Creates the tasks in groups of four on all task prios: a ping and a pong
+// task passing semaphores back and forth, and a producer and a consumer on
+// a queue. Everything runs for the given number of ticks, after which the
+// queue contents are checked and the throughput is printed. Returns non-zero
+// if a message was lost or reordered.
+
+#define STRESS_QUEUE_ITEMS  (4)
+#define STRESS_BURST        (6)     // Pushes per producer period, more than fits
+#define STRESS_TIMEOUT      (0x7FFFFFFF)
+
+typedef struct {
+  rt_sem_t ping;
+  rt_sem_t pong;
+  rt_queue_t queue;
+  uint32_t queue_buffer[STRESS_QUEUE_ITEMS];
+  uint32_t period;
+  uint32_t produced;
+  uint32_t consumed;
+} stress_group_t;
+
+static rt_task_t stress_create(void (*fcn)(void *), const char *name, const uint32_t prio, void *p);
+static void stress_sleep(const uint32_t ticks);
+static void stress_ping_fcn(void *p);
+static void stress_pong_fcn(void *p);
+static void stress_producer_fcn(void *p);
+static void stress_consumer_fcn(void *p);
+static void stress_ctrl_fcn(void *p);
+
+static rt_sem_t sem_never;
+
+static uint32_t n_pings = 0;
+static uint32_t n_ping_timeouts = 0;
+static uint32_t n_messages = 0;
+static uint32_t n_errors = 0;
+
+int main(int argc, char *argv[])
+{
+  uint32_t n_tasks = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1000;
+  uint32_t n_ticks = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1000;
+  uint32_t i, n_groups = (n_tasks + 3) / 4;
+  struct timespec t0, t1;
+  double seconds;
+  stress_group_t *group = calloc(n_groups, sizeof(stress_group_t));
+
+  if (group == NULL)
+    return 1;
+
+  rt_init();
+
+  rt_sem_init(&sem_never, 0);
+
+  for (i = 0; i < n_groups; i++) {
+    uint32_t prio = 1 + i % (RT_PRIO_LEVELS-1);
+
+    rt_sem_init(&(group[i].ping), 0);
+    rt_sem_init(&(group[i].pong), 0);
+    rt_queue_init(&(group[i].queue), (uint8_t *) group[i].queue_buffer, sizeof(uint32_t), STRESS_QUEUE_ITEMS);
+    group[i].period = 1 + i % 5;
+
+    if (stress_create(stress_ping_fcn, "PING", prio, &group[i]) == NULL
+        || stress_create(stress_pong_fcn, "PONG", prio, &group[i]) == NULL
+        || stress_create(stress_producer_fcn, "PROD", prio, &group[i]) == NULL
+        || stress_create(stress_consumer_fcn, "CONS", RT_PRIO_LEVELS-1-(prio-1), &group[i]) == NULL) {
+      fprintf(stderr, "Out of memory after %u tasks\n", 4*i);
+      return 1;
+    }
+  }
+
+  stress_create(stress_ctrl_fcn, "CTRL", RT_PRIO_LEVELS-1, (void *) (uintptr_t) n_ticks);
+
+  // rt_get_cycles wraps after a few seconds
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  rt_start();
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+  for (i = 0; i < n_groups; i++) {
+    // Whatever is still queued was produced but not yet consumed. With a
+    // SIGALRM tick the producer may be stopped right after a push, before
+    // counting it.
+    uint32_t pushed = group[i].consumed + group[i].queue.items;
+
+    if (pushed != group[i].produced && pushed != group[i].produced + 1)
+      n_errors++;
+  }
+
+  printf("tasks %u, ticks %u: %u switches, %u ping-pongs (%u timed out), %u messages, %u errors\n",
+         4*n_groups, rt_get_tick(), rt_port_switch_count(), n_pings, n_ping_timeouts, n_messages, n_errors);
+  printf("%.3f s, %.0f ns per switch\n", seconds,
+         seconds * 1e9 / (rt_port_switch_count() ? rt_port_switch_count() : 1));
+
+  free(group);
+
+  return (n_errors > 0);
+}
+
+static rt_task_t stress_create(void (*fcn)(void *), const char *name, const uint32_t prio, void *p)
+{
+  // The host port provides the stack, so none is allocated here
+  rt_task_t task = malloc(sizeof(rt_tcb_t));
+
+  if (task == NULL)
+    return NULL;
+
+  *task = (rt_tcb_t) TCB_INIT(NULL, (void *) fcn, name, prio, 0);
+
+  if (rt_create_task(task, p) != RT_OK) {
+    free(task);
+    return NULL;
+  }
+
+  return task;
+}
+
+static void stress_sleep(const uint32_t ticks)
+{
+  rt_sem_take(&sem_never, ticks);
+}
+
+static void stress_ping_fcn(void *p)
+{
+  stress_group_t *group = (stress_group_t *) p;
+
+  while (1) {
+    rt_sem_give(&(group->ping));
+
+    if (rt_sem_take(&(group->pong), 2) == RT_OK)
+      n_pings++;
+    else
+      n_ping_timeouts++;
+
+    stress_sleep(group->period);
+  }
+}
+
+static void stress_pong_fcn(void *p)
+{
+  stress_group_t *group = (stress_group_t *) p;
+
+  while (1) {
+    if (rt_sem_take(&(group->ping), STRESS_TIMEOUT) == RT_OK)
+      rt_sem_give(&(group->pong));
+  }
+}
+
+static void stress_producer_fcn(void *p)
+{
+  stress_group_t *group = (stress_group_t *) p;
+  uint32_t i;
+
+  while (1) {
+    for (i = 0; i < STRESS_BURST; i++) {
+      if (rt_queue_push(&(group->queue), (void *) &(group->produced), group->period) == RT_OK)
+        group->produced++;
+    }
+
+    stress_sleep(group->period);
+  }
+}
+
+static void stress_consumer_fcn(void *p)
+{
+  stress_group_t *group = (stress_group_t *) p;
+  uint32_t item;
+
+  while (1) {
+    if (rt_queue_pull(&(group->queue), &item, STRESS_TIMEOUT) == RT_OK) {
+      // Items are sequence numbers, so anything lost or reordered shows
+      if (item != group->consumed)
+        n_errors++;
+
+      group->consumed = item + 1;
+      n_messages++;
+    }
+  }
+}
+
+static void stress_ctrl_fcn(void *p)
+{
+  stress_sleep((uint32_t) (uintptr_t) p);
+
+  rt_port_stop();
+}
@@ -13,10 +13,10 @@ static void Error_Handler(void);
 
 #define TASK_STACK_SIZE 512  
 
-DEFINE_TASK(task_1_fcn, task_1, "T1", 2, TASK_STACK_SIZE);
-DEFINE_TASK(task_2_fcn, task_2, "T2", 1, TASK_STACK_SIZE);
-DEFINE_TASK(task_3_fcn, task_3, "T3", 3, TASK_STACK_SIZE);
-DEFINE_TASK(task_4_fcn, task_4, "T4", 3, TASK_STACK_SIZE);
+DEFINE_STATIC_TASK(task_1_fcn, task_1, "T1", 2, TASK_STACK_SIZE, NULL);
+DEFINE_STATIC_TASK(task_2_fcn, task_2, "T2", 1, TASK_STACK_SIZE, NULL);
+DEFINE_STATIC_TASK(task_3_fcn, task_3, "T3", 3, TASK_STACK_SIZE, NULL);
+DEFINE_STATIC_TASK(task_4_fcn, task_4, "T4", 3, TASK_STACK_SIZE, NULL);
 
 rt_sem_t semaphore, semaphore_2;
 
@@ -212,6 +212,8 @@ void init_timer()
 
 void TIM3_IRQHandler()
 {
+  RT_TRACE_ISR_ENTER();
+
   if (__HAL_TIM_GET_ITSTATUS(&handler_timer, TIM_IT_UPDATE) != RESET) {
       __HAL_TIM_CLEAR_FLAG(&handler_timer, TIM_FLAG_UPDATE);
 
@@ -223,6 +225,8 @@ void TIM3_IRQHandler()
         rt_pend_yield();
       
   }
+
+  RT_TRACE_ISR_EXIT();
 }
 
 
@@ -0,0 +1,231 @@
+/*
+ * rt_basic.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_kernel.h"
+#include "rt_sem.h"
+#include "rt_basic.h"
+
+#if RT_BASIC_ENABLE
+
+#define RT_BASIC_NONE     (-1)            // Level when no basic task is on the stack
+#define RT_BASIC_TIMEOUT  (0x7FFFFFFF)    // Ticks, long enough to be forever
+
+static void rt_basic_run(const int32_t level);
+static void rt_basic_nested(const uint32_t level);
+static void rt_basic_prio(const uint32_t prio);
+static int32_t rt_basic_highest_pending(void);
+
+DEFINE_TASK(rt_basic_task, basic_task, "BASIC", 0, RT_BASIC_STACK_SIZE);
+
+static volatile list_sorted_t pending[RT_PRIO_LEVELS];
+static rt_sem_t basic_sem;                              // Wakes the BASIC task up
+static volatile uint32_t basic_idle = 1;                // BASIC task waits for basic_sem
+static volatile int32_t running_prio = RT_BASIC_NONE;   // Of the basic task on top of the stack
+
+void rt_basic_task(void *p)
+{
+  while (1) {
+    rt_basic_run(RT_BASIC_NONE);
+
+    rt_sem_take(&basic_sem, RT_BASIC_TIMEOUT);
+  }
+}
+
+void rt_basic_init(void)
+{
+  uint8_t prio;
+
+  for (prio=0; prio<RT_PRIO_LEVELS; prio++)
+    list_sorted_init((list_sorted_t *) &(pending[prio]));
+
+  rt_sem_init(&basic_sem, 0);
+  RT_OBJ_NAME(&basic_sem, "BASIC");
+
+  rt_create_task(&basic_task, NULL);
+}
+
+uint32_t rt_activate(rt_basic_t * const basic)
+{
+  // From a task or an ISR
+  uint32_t prio = basic->priority;
+  int32_t nest_level = RT_BASIC_NONE;
+
+  if (prio >= RT_PRIO_LEVELS)
+    return RT_NOK;
+
+  rt_enter_critical();
+
+  (basic->activations)++;
+
+  if (basic->list_item.list == NULL) {
+    basic->list_item.value = prio;
+    basic->list_item.reference = (void *) basic;
+    list_sorted_insert((list_sorted_t *) &(pending[prio]), &(basic->list_item));
+  }
+
+  if (basic_idle) {
+    basic_idle = 0;
+    rt_list_task_prio(&basic_task, prio);
+
+    if (rt_sem_give_from_isr(&basic_sem) == RT_OK)
+      rt_pend_yield();
+
+  } else {
+    if (prio > basic_task.priority) {
+      rt_list_task_prio(&basic_task, prio);
+
+      if (prio > current_task->priority)
+        rt_pend_yield();
+    }
+
+    if (running_prio != RT_BASIC_NONE && (int32_t) prio > running_prio) {
+      if (current_task == &basic_task && !rt_port_active_irq()) {
+        // From a basic task, so simply call it
+        nest_level = running_prio;
+      } else {
+        // Nested by rt_basic_switched when BASIC runs next
+        rt_pend_yield();
+      }
+    }
+  }
+
+  rt_exit_critical();
+
+  if (nest_level != RT_BASIC_NONE)
+    rt_basic_run(nest_level);
+
+  return RT_OK;
+}
+
+void rt_basic_switched(rt_tcb_t * const task)
+{
+  // Called by rt_switch_task. A basic task of higher prio than the one on
+  // top of the stack was activated by an ISR or another task, so it has to
+  // run on top of it before BASIC continues.
+  if (task == &basic_task && running_prio != RT_BASIC_NONE && rt_basic_highest_pending() > running_prio)
+    rt_port_nest(task, rt_basic_nested, (uint32_t) running_prio);
+}
+
+int32_t rt_basic_ceiling_raise(const uint32_t ceiling)
+{
+  // From rt_resource_get, in a critical section. In a basic task the
+  // ceiling also holds off nesting of basic tasks up to it.
+  int32_t level = running_prio;
+
+  if (current_task != &basic_task)
+    return RT_BASIC_NONE;
+
+  if ((int32_t) ceiling > running_prio)
+    running_prio = ceiling;
+
+  return level;
+}
+
+uint32_t rt_basic_ceiling_restore(const int32_t level, const uint32_t prio)
+{
+  // From rt_resource_release, in a critical section. Returns the prio that
+  // BASIC should drop to, which is above prio if basic tasks that were held
+  // off by the ceiling got pending.
+  int32_t highest;
+
+  if (level == RT_BASIC_NONE)
+    return prio;
+
+  running_prio = level;
+
+  highest = rt_basic_highest_pending();
+
+  if (highest <= level)
+    return prio;
+
+  // Nested by rt_basic_switched
+  rt_pend_yield();
+
+  return ((uint32_t) highest > prio) ? (uint32_t) highest : prio;
+}
+
+static void rt_basic_nested(const uint32_t level)
+{
+  rt_basic_run((int32_t) level);
+}
+
+static void rt_basic_run(const int32_t level)
+{
+  // Runs the pending basic tasks of higher prio than level, highest first,
+  // on top of whatever is on the stack already
+  rt_basic_t *basic;
+  int32_t prio;
+
+  rt_enter_critical();
+
+  while ((prio = rt_basic_highest_pending()) > level) {
+    basic = (rt_basic_t *) LIST_FIRST_REF(&(pending[prio]));
+
+    // Activated more than once: again, after the others of the same prio
+    list_sorted_remove(&(basic->list_item));
+    if (--(basic->activations) > 0)
+      list_sorted_insert((list_sorted_t *) &(pending[prio]), &(basic->list_item));
+
+    running_prio = prio;
+
+    // At the prio of the one that runs now, also after one of higher prio
+    rt_basic_prio(prio);
+
+    rt_exit_critical();
+
+    basic->code(basic->parameters);
+
+    rt_enter_critical();
+
+    running_prio = level;
+  }
+
+  if (level == RT_BASIC_NONE) {
+    basic_idle = 1;
+    rt_basic_prio(0);
+  } else {
+    // Back to the prio of the basic task below
+    rt_basic_prio(level);
+  }
+
+  rt_exit_critical();
+}
+
+static void rt_basic_prio(const uint32_t prio)
+{
+  // Moves BASIC to prio. If that is lower, whatever is ready above it runs
+  // now, as in rt_resource_release.
+  uint32_t ready_prio;
+
+  if (prio > basic_task.priority) {
+    rt_list_task_prio(&basic_task, prio);
+
+  } else if (prio < basic_task.priority) {
+    rt_list_task_prio(&basic_task, prio);
+
+    for (ready_prio = RT_PRIO_LEVELS-1; ready_prio > prio; ready_prio--) {
+      if (LIST_LENGTH(&(ready[ready_prio])) > 0) {
+        rt_pend_yield();
+        break;
+      }
+    }
+  }
+}
+
+static int32_t rt_basic_highest_pending(void)
+{
+  int32_t prio;
+
+  for (prio = RT_PRIO_LEVELS-1; prio >= 0; prio--) {
+    if (LIST_LENGTH(&(pending[prio])) > 0)
+      break;
+  }
+
+  return prio;
+}
+
+#endif
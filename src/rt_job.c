@@ -0,0 +1,154 @@
+/*
+ * rt_job.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_kernel.h"
+#include "rt_job.h"
+
+#if RT_JOB_STATS_ENABLE
+
+enum {
+  RT_JOB_STATE_NONE = 0,    // Not (yet) using rt_periodic_delay
+  RT_JOB_STATE_WAITING,     // In rt_periodic_delay
+  RT_JOB_STATE_RELEASED,    // Woken up, but not switched in yet
+  RT_JOB_STATE_RUNNING
+};
+
+static rt_job_overrun_hook_t overrun_hook = NULL;
+
+void rt_job_release(rt_tcb_t * const task)
+{
+  // Called by the tick for every woken task, but only the ones delayed by
+  // rt_periodic_delay are released. E.g. a timeout of rt_sem_take is not.
+  rt_job_t *job = &(task->job);
+
+  if (job->state == RT_JOB_STATE_WAITING) {
+    job->state = RT_JOB_STATE_RELEASED;
+    job->release = rt_get_cycles();
+    job->release_tick = rt_get_tick();
+    job->exec = 0;
+  }
+}
+
+void rt_job_late_release(rt_tcb_t * const task)
+{
+  // Called by rt_periodic_delay when the job was done after the next
+  // release was due. The next job is released at once and already runs.
+  rt_job_t *job = &(task->job);
+
+  if (job->state == RT_JOB_STATE_WAITING) {
+    job->state = RT_JOB_STATE_RUNNING;
+    job->release = rt_get_cycles();
+    job->release_tick = rt_get_tick();
+    job->exec = 0;
+    job->switched_in = job->release;
+
+    job->stats.start_min = 0;
+    job->stats.late_releases++;
+  }
+}
+
+void rt_job_switch(rt_tcb_t * const prev_task, rt_tcb_t * const next_task)
+{
+  uint32_t now = rt_get_cycles();
+  uint32_t start;
+  rt_job_t *job = &(prev_task->job);
+
+  if (job->state == RT_JOB_STATE_RUNNING)
+    job->exec += now - job->switched_in;
+
+  job = &(next_task->job);
+
+  if (job->state == RT_JOB_STATE_RELEASED) {
+    start = now - job->release;
+
+    if (job->stats.jobs == 0 || start < job->stats.start_min)
+      job->stats.start_min = start;
+    if (start > job->stats.start_max)
+      job->stats.start_max = start;
+
+    job->state = RT_JOB_STATE_RUNNING;
+  }
+
+  job->switched_in = now;
+}
+
+void rt_job_done(rt_tcb_t * const task, const uint32_t period)
+{
+  uint32_t now = rt_get_cycles();
+  uint32_t deadline = (task->timing.deadline > 0) ? task->timing.deadline : period;
+  uint32_t response = 0, overrun = 0;
+  rt_job_t *job = &(task->job);
+
+  rt_enter_critical();
+
+  if (job->state == RT_JOB_STATE_RUNNING) {
+    job->exec += now - job->switched_in;
+    response = now - job->release;
+
+    if (job->stats.jobs == 0 || job->exec < job->stats.exec_min)
+      job->stats.exec_min = job->exec;
+    if (job->exec > job->stats.exec_max)
+      job->stats.exec_max = job->exec;
+    job->stats.exec_sum += job->exec;
+
+    if (job->stats.jobs == 0 || response < job->stats.response_min)
+      job->stats.response_min = response;
+    if (response > job->stats.response_max)
+      job->stats.response_max = response;
+
+    // Done at the deadline tick or later
+    if (rt_get_tick() - job->release_tick >= deadline) {
+      job->stats.overruns++;
+      overrun = 1;
+    }
+
+    job->stats.jobs++;
+  }
+
+  job->state = RT_JOB_STATE_WAITING;
+
+  rt_exit_critical();
+
+  if (overrun && overrun_hook != NULL)
+    overrun_hook(task, response);
+}
+
+void rt_job_stats_get(rt_tcb_t * const task, rt_job_stats_t *stats)
+{
+  // A consistent copy, the mean execution time is exec_sum/jobs
+  rt_enter_critical();
+  *stats = task->job.stats;
+  rt_exit_critical();
+}
+
+void rt_job_stats_reset(rt_tcb_t * const task)
+{
+  // Keeps the measurement of the current job going
+  rt_job_t *job = &(task->job);
+
+  rt_enter_critical();
+
+  job->stats.jobs = 0;
+  job->stats.overruns = 0;
+  job->stats.exec_min = 0;
+  job->stats.exec_max = 0;
+  job->stats.exec_sum = 0;
+  job->stats.response_min = 0;
+  job->stats.response_max = 0;
+  job->stats.start_min = 0;
+  job->stats.start_max = 0;
+  job->stats.late_releases = 0;
+
+  rt_exit_critical();
+}
+
+void rt_job_set_overrun_hook(rt_job_overrun_hook_t hook)
+{
+  overrun_hook = hook;
+}
+
+#endif
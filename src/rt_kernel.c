@@ -7,19 +7,14 @@
 
 #include "rt_kernel.h"
 
-#include "debug.h"
+#if RT_STACK_MONITOR_ENABLE
+static void rt_stack_monitor_step();
+#endif
 
-static uint32_t rt_init_interrupt_prios();
-static uint32_t * rt_init_stack(void *code, void * const task_parameters, const uint32_t stack_size, volatile void * stack_data);
-static void rt_error_handler(uint8_t err);
-static uint32_t rt_increment_tick();
-
-
-void rt_switch_task();
-
-DEFINE_TASK(rt_idle, idle_task, "IDLE", 0, RT_IDLE_TASK_STACK_SIZE);
+DEFINE_STATIC_TASK(rt_idle, idle_task, "IDLE", 0, RT_IDLE_TASK_STACK_SIZE, NULL);
 
 rt_task_t volatile current_task = NULL;
+static rt_task_t task_list = NULL;
 
 volatile uint32_t tick = 0;
 static volatile uint32_t ticks_in_suspend = 0;
@@ -31,7 +26,13 @@ static volatile uint32_t nest_critical = 0;
 void rt_idle(void *p)
 {
   while (1) {
-    DBG_PAD4_SET;
+    rt_port_idle();
+
+    RT_TRACE_FLUSH();
+
+#if RT_STACK_MONITOR_ENABLE
+    rt_stack_monitor_step();
+#endif
   }
 }
 
@@ -73,62 +74,80 @@ uint32_t rt_get_tick(void)
   return tick;
 }
 
-static uint32_t * rt_init_stack(void *code, void * const task_parameters, const uint32_t stack_size, volatile void * stack_data)
-{
-  uint32_t *stackptr = (uint32_t *) stack_data;
-  stackptr = (uint32_t*) &stackptr[stack_size-1];
-
-  // Needs to be 8-byte aligned
-  if ((uint32_t) stackptr & 0x04) {
-    stackptr--;
-  }
-
-  // PSR
-  *stackptr-- = (uint32_t) 0x01000000;
-
-  // PC, as PC is loaded on exit from ISR, bit0 must be zero
-  *stackptr-- = (uint32_t) code & 0xFFFFFFFE;
-
-  // LR: Use non-floating point popping and use psp when returning
-  *stackptr = (uint32_t) 0xFFFFFFFD;
-
-  // R12, R3, R2, R1
-  stackptr -= 5;
-  
-  // R0
-  *stackptr-- = (uint32_t) task_parameters;
-
-  *stackptr = (uint32_t) 0xFFFFFFFD;
-
-  // R11, R10, R9, R8, R7, R6, R5, R4
-  stackptr -= 8;
-
-  return stackptr;
-}
-
 uint32_t rt_create_task(rt_task_t const task, void * const task_parameters)
 {
   uint32_t prio = task->priority;
 
+#if RT_STATIC_IMAGE_ENABLE
+  if (task->list_item.list != NULL) {
+    // Prebuilt, already in its ready list
+    RT_TRACE_TASK_CREATE(task);
+    return RT_OK;
+  }
+#endif
+
   if (prio >= RT_PRIO_LEVELS) {
     task->priority = RT_PRIO_LEVELS - 1;
     task->base_prio = RT_PRIO_LEVELS - 1;
   }
 
-  task->sp = rt_init_stack(task->code_start, task_parameters, task->stack_size, task->sp);
+  task->sp = rt_port_init_stack(task, task_parameters);
 
   if (task->sp == NULL)
     return RT_NOK;
 
+  rt_enter_critical();
+  task->next_task = task_list;
+  task_list = task;
+  rt_exit_critical();
+
   task->list_item.reference = (void *) task;
   task->blocked_list_item.reference = (void *) task;
 
   // Add to the ready list that correponds to the task prio
   rt_list_task_ready(task);
 
+  RT_TRACE_TASK_CREATE(task);
+
   return RT_OK;
 }
 
+uint32_t rt_task_stack_high_water(rt_task_t const task)
+{
+  // The stack grows downwards, so the untouched part is at the start
+  const uint32_t *stack = task->stack_start;
+  uint32_t free_words = RT_STACK_GUARD_WORDS;
+
+  while (free_words < task->stack_size && stack[free_words] == RT_STACK_FILL_PATTERN)
+    free_words++;
+
+  task->stack_peak = task->stack_size - free_words;
+
+  return task->stack_peak;
+}
+
+rt_task_t rt_task_list(void)
+{
+  // Iterate using task->next_task
+  return task_list;
+}
+
+#if RT_STACK_MONITOR_ENABLE
+static void rt_stack_monitor_step()
+{
+  // Check one task per call to not starve anything else running in idle
+  static rt_task_t task = NULL;
+
+  if (task == NULL)
+    task = task_list;
+
+  if (task != NULL) {
+    rt_task_stack_high_water(task);
+    task = task->next_task;
+  }
+}
+#endif
+
 void rt_yield(void)
 {
   rt_pend_yield();
@@ -139,19 +158,29 @@ void rt_periodic_delay(const uint32_t period)
 {
   // This does of course not guarantee that the task will execute in the specified period
   // if there are other tasks of higher prio...
+  RT_JOB_DONE(current_task, period);
+
   rt_enter_critical();
 
   uint32_t task_nominal_wakeup_tick = current_task->delay_woken_tick + period;
 
-  rt_list_task_delayed(current_task, task_nominal_wakeup_tick);
+  if (task_nominal_wakeup_tick > rt_get_tick()) {
+    rt_list_task_delayed(current_task, task_nominal_wakeup_tick);
+  } else {
+    // Too late to wait, the next period starts now
+    current_task->delay_woken_tick = rt_get_tick();
+    RT_JOB_LATE_RELEASE(current_task);
+  }
 
   rt_exit_critical();
 }
 
-static uint32_t rt_increment_tick()
+uint32_t rt_increment_tick()
 {
   // Figure out if context switch is needed and update ready list...
 
+  RT_TRACE_FLUSH();
+
   if (kernel_suspended) {
     ++ticks_in_suspend;
     return RT_NOK;
@@ -168,6 +197,8 @@ static uint32_t rt_increment_tick()
     
     woken_task->delay_woken_tick = tick;
 
+    RT_JOB_RELEASE(woken_task);
+
     rt_list_task_undelayed(woken_task); // Updates next_wakeup_tick and next_wakeup_task
 
     // Make it the next one up in its prio ready list
@@ -188,6 +219,7 @@ static uint32_t rt_increment_tick()
 void rt_switch_task()
 {
   uint8_t prio;
+  rt_task_t previous_task = current_task;
 
   rt_mask_irq();
 
@@ -196,28 +228,47 @@ void rt_switch_task()
 
   // TODO: Check if there actually are any ready tasks?
 
-  // Get the next reference in the ready list
-  current_task = (rt_task_t) list_sorted_get_iter_ref((list_sorted_t *) &(ready[prio]));
+  // Get the next reference in the ready list, but no round robin away from
+  // a task that holds a resource at this prio
+  if (rt_resource_holder != NULL && rt_resource_holder->list_item.list == (void *) &(ready[prio]))
+    current_task = rt_resource_holder;
+  else
+    current_task = (rt_task_t) list_sorted_get_iter_ref((list_sorted_t *) &(ready[prio]));
 
-  DBG_PAD4_RESET;
+  if (current_task != previous_task) {
+    rt_port_task_switched(current_task);
 
-  rt_unmask_irq();
-}
+    RT_JOB_SWITCH(previous_task, current_task);
 
-static uint32_t rt_init_interrupt_prios()
-{
-  NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4); // No sub-priorities
+    RT_TRACE_SWITCH_OUT(previous_task);
+    RT_TRACE_SWITCH_IN(current_task);
+  }
 
-  NVIC_SetPriority(PendSV_IRQn, RT_KERNEL_IRQ_PRIO);    // Set lowest prio
-  NVIC_SetPriority(SysTick_IRQn, RT_KERNEL_IRQ_PRIO);
+  RT_BASIC_SWITCHED(current_task);
 
-  return RT_OK;
+  rt_unmask_irq();
 }
 
 uint32_t rt_init()
 {
+  rt_port_init();
+
+#if RT_TRACE_ENABLE
+  rt_trace_init();
+#endif
+
   rt_lists_delayed_init();
+
+#if RT_STATIC_IMAGE_ENABLE
+  // The ready lists and the static tasks in them are already in .data
+  task_list = rt_image_task_list;
+#else
   rt_lists_ready_init();
+#endif
+
+#if RT_BASIC_ENABLE
+  rt_basic_init();
+#endif
 
   return RT_OK;
 }
@@ -237,80 +288,9 @@ void rt_start()
 
   current_task = (rt_task_t) LIST_MIN_VALUE_REF(&(ready[prio]));
 
-  if (rt_init_interrupt_prios()) {
-    // Brace yourselves, the kernel is starting!
-    rt_unmask_irq();
-    rt_enable_irq();
-
-    __asm volatile (" svc 0 " );  // Need to be in handler mode to restore correctly => system call
-  }
-
-}
+  RT_TRACE_SWITCH_IN(current_task);
 
-void rt_syscall()
-{
-  __asm volatile (
-    " ldr r0, [%[SP]]           \n\t"
-    " ldmia r0!, {r4-r11, lr}   \n\t"
-    " msr psp, r0               \n\t" // Restore the process stack pointer
-    " isb                       \n\t"
-    " bx lr                     \n\t"
-    : 
-    : [SP] "r" (&(current_task->sp))
-    : 
-  );
-}
-
-void rt_systick()
-{
-  HAL_IncTick();
-
-  rt_mask_irq();
-
-  if (RT_OK==rt_increment_tick()) 
-    rt_pend_yield();
-  
-  rt_unmask_irq();
-}
-
-void rt_switch_context()
-{
-  __asm volatile (
-    " mrs r0, psp               \n\t" // psp -> r0
-    " isb                       \n\t" // Instruction synchronization barrier
-    " tst lr, #0x10             \n\t" // Check LR:
-    " it eq                     \n\t" // Push upper floating point regs if used by process
-    " vstmdbeq r0!, {s16-s31}   \n\t"
-    "                           \n\t"
-    " stmdb r0!, {r4-r11, lr}   \n\t" // Push rest of core regs, and specifically lr so that 
-    "                           \n\t" // it can be checked by switcher for fp use when restoring
-    " str r0, [%[SP]]           \n\t" // Store current stack-pointer to tcb
-    " dsb                       \n\t"
-    " isb                       \n\t"
-    " bl rt_switch_task         \n\t" // Possibly change context to next process
-    "                           \n\t"
-    :
-    : [SP] "r" (&(current_task->sp))
-    :
-  );
-
-  // Split inline assembly to force re-evaluation of current_task (updated by context switcher)
-
-  __asm volatile (
-    " ldr r0, [%[SP]]           \n\t" // Get stack-pointer from tcb
-    " ldmia r0!, {r4-r11, lr}   \n\t" // Pop rest of core regs, and specifically lr
-    "                           \n\t"
-    " tst lr, #0x10             \n\t" // Check LR: 
-    " it eq                     \n\t" // Pop upper floating point regs if used by process
-    " vldmiaeq r0!, {s16-s31}   \n\t"
-    "                           \n\t"
-    " msr psp, r0               \n\t" // Restore the process stack pointer
-    " isb                       \n\t"
-    " bx lr                     \n\t" // Continue next task
-    :
-    : [SP] "r" (&(current_task->sp))
-    :
-  );
+  rt_port_start();
 }
 
 void rt_error_handler(uint8_t err)
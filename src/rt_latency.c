@@ -0,0 +1,96 @@
+/*
+ * rt_latency.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_kernel.h"
+#include "rt_latency.h"
+
+#if RT_LATENCY_ENABLE
+
+#define RT_LATENCY_SUB_BUCKETS (1 << RT_LATENCY_SUB_BITS)
+
+static uint32_t rt_latency_bucket(const uint32_t cycles)
+{
+  uint32_t msb, bucket;
+
+  if (cycles < RT_LATENCY_SUB_BUCKETS)
+    return cycles;
+
+  // A single clz on the M4
+  msb = 31 - __builtin_clz(cycles);
+
+  bucket = (msb - RT_LATENCY_SUB_BITS + 1) * RT_LATENCY_SUB_BUCKETS
+         + ((cycles >> (msb - RT_LATENCY_SUB_BITS)) & (RT_LATENCY_SUB_BUCKETS - 1));
+
+  return (bucket < RT_LATENCY_BUCKETS) ? bucket : RT_LATENCY_BUCKETS - 1;
+}
+
+uint32_t rt_latency_bucket_low(const uint32_t bucket)
+{
+  uint32_t msb;
+
+  if (bucket < RT_LATENCY_SUB_BUCKETS)
+    return bucket;
+
+  msb = bucket / RT_LATENCY_SUB_BUCKETS + RT_LATENCY_SUB_BITS - 1;
+
+  return (RT_LATENCY_SUB_BUCKETS + bucket % RT_LATENCY_SUB_BUCKETS) << (msb - RT_LATENCY_SUB_BITS);
+}
+
+void rt_latency_give(rt_tcb_t * const task, rt_latency_hist_t * const hist)
+{
+  // Tasks giving to each other are not of interest here
+  if (rt_port_active_irq() != 0) {
+    task->latency_hist = hist;
+    task->latency_start = rt_get_cycles();
+  }
+}
+
+void rt_latency_woken(rt_tcb_t * const task)
+{
+  // Called within a critical section when the task is back from blocking
+  rt_latency_hist_t *hist = task->latency_hist;
+  uint32_t cycles;
+
+  if (hist == NULL)
+    return;
+
+  cycles = rt_get_cycles() - task->latency_start;
+  task->latency_hist = NULL;
+
+  if (hist->count == 0 || cycles < hist->min)
+    hist->min = cycles;
+  if (cycles > hist->max)
+    hist->max = cycles;
+
+  hist->count++;
+  hist->bucket[rt_latency_bucket(cycles)]++;
+}
+
+void rt_latency_read(rt_latency_hist_t * const hist, rt_latency_hist_t *copy)
+{
+  rt_enter_critical();
+  *copy = *hist;
+  rt_exit_critical();
+}
+
+void rt_latency_reset(rt_latency_hist_t * const hist)
+{
+  uint32_t i;
+
+  rt_enter_critical();
+
+  hist->count = 0;
+  hist->min = 0;
+  hist->max = 0;
+
+  for (i = 0; i < RT_LATENCY_BUCKETS; i++)
+    hist->bucket[i] = 0;
+
+  rt_exit_critical();
+}
+
+#endif
@@ -9,7 +9,10 @@
 
 
 static volatile list_sorted_t delayed[RT_PRIO_LEVELS];
+// With RT_STATIC_IMAGE_ENABLE it is prebuilt by tools/rt_image.py
+#if !RT_STATIC_IMAGE_ENABLE
 volatile list_sorted_t ready[RT_PRIO_LEVELS];
+#endif
 
 static void update_next_wakeup(void);
 static list_item_t *list_sorted_next_item(list_item_t *item);
@@ -89,6 +92,12 @@ void rt_lists_delayed_init(void)
     list_sorted_init((list_sorted_t *) &(delayed[prio]));
 }
 
+// The prio is also the value of the list item, and list_sorted_insert
+// treats LIST_END_VALUE specially. GCC threads that case back to here and
+// warns about ready[0xFFFFFFFF], which no task prio can be.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+
 void rt_list_task_ready(rt_task_t const task)
 {
   uint32_t task_prio = task->priority;
@@ -106,6 +115,24 @@ void rt_list_task_ready_next(rt_task_t const task)
   list_sorted_iter_insert((list_sorted_t *) &(ready[task_prio]), list_item);
 }
 
+void rt_list_task_prio(rt_task_t const task, const uint32_t prio)
+{
+  // A ready task moves to the ready list of the new prio, next up there.
+  // Otherwise the new prio applies when it gets ready. The caller decides
+  // if a switch is needed.
+  list_item_t *list_item = &(task->list_item);
+
+  if (list_item->list == (void *) &(ready[task->priority])) {
+    list_sorted_remove(list_item);
+    task->priority = prio;
+    rt_list_task_ready_next(task);
+  } else {
+    task->priority = prio;
+  }
+}
+
+#pragma GCC diagnostic pop
+
 void rt_list_task_delayed(rt_task_t const task, const uint32_t wake_up_tick)
 {
   list_sorted_t *delayed_list = (list_sorted_t *) &(delayed[task->priority]);
@@ -120,6 +147,8 @@ void rt_list_task_delayed(rt_task_t const task, const uint32_t wake_up_tick)
 
     update_next_wakeup();
 
+    RT_TRACE_DELAY(task, wake_up_tick);
+
     // Trig a task switch
     rt_pend_yield();
   }
@@ -130,6 +159,8 @@ void rt_list_task_undelayed(rt_task_t const task)
   // NOTE: Does not set task as Ready!
   list_sorted_remove(&(task->list_item));
   update_next_wakeup();
+
+  RT_TRACE_WAKE(task);
 }
 
 void *list_sorted_get_iter_ref(list_sorted_t *list)
@@ -208,7 +239,9 @@ uint32_t list_sorted_remove(list_item_t *item)
     (from_list->len)--;
     item->list = NULL;
 
+    return from_list->len;
   }
 
-  return from_list->len;
+  // Not in any list, e.g. already unblocked by a give/push
+  return 0;
 }
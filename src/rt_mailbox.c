@@ -0,0 +1,156 @@
+/*
+ * rt_mailbox.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_mailbox.h"
+#include "rt_queue.h"
+#include "rt_kernel.h"
+
+uint32_t rt_mailbox_init(rt_mailbox_t *mb, uint8_t *buffer, uint32_t item_size, uint32_t slots)
+{
+  if (slots == 0 || (slots & (slots - 1)) != 0)
+    return RT_NOK;
+
+  mb->buffer = buffer;
+  mb->item_size = item_size;
+  mb->slots = slots;
+  mb->seq = 0;
+  mb->started = 0;
+
+  list_sorted_init((list_sorted_t *) &(mb->blocked));
+
+  RT_LATENCY_INIT(&(mb->latency));
+  RT_OBJ_REGISTER(&(mb->obj), RT_OBJ_MAILBOX);
+
+  return RT_OK;
+}
+
+uint32_t rt_mailbox_write_from_isr(rt_mailbox_t *mb, const void * const item)
+{
+  // Never fails. RT_OK if a task of higher prio was unblocked.
+  uint32_t seq;
+  uint32_t task_unblocked = RT_NOK;
+  rt_task_t unblocked_task;
+
+  rt_enter_critical();
+
+  seq = mb->seq + 1;
+
+  // Readers of the slot that is overwritten now retry
+  mb->started = seq;
+  rt_port_barrier();
+
+  rt_queue_copy(mb->buffer + (seq & (mb->slots - 1)) * mb->item_size, (const uint8_t *) item, mb->item_size);
+
+  rt_port_barrier();
+  mb->seq = seq;
+
+  RT_OBJ_DEPTH(&(mb->obj), 1);
+
+  // Everyone waiting wants the new value
+  while (LIST_LENGTH(&(mb->blocked)) > 0) {
+    unblocked_task = (rt_task_t) LIST_MAX_VALUE_REF(&(mb->blocked));
+    list_sorted_remove((list_item_t *) &(unblocked_task->blocked_list_item));
+    rt_list_task_undelayed(unblocked_task);
+    rt_list_task_ready_next(unblocked_task);
+
+    RT_TRACE_UNBLOCK(unblocked_task, mb);
+    RT_LATENCY_GIVE(unblocked_task, &(mb->latency));
+
+    if (unblocked_task->priority >= current_task->priority)
+      task_unblocked = RT_OK;
+  }
+
+  rt_exit_critical();
+
+  return task_unblocked;
+}
+
+uint32_t rt_mailbox_write(rt_mailbox_t *mb, const void * const item)
+{
+  rt_enter_critical();
+
+  if (rt_mailbox_write_from_isr(mb, item) != RT_NOK)
+    rt_pend_yield();
+
+  rt_exit_critical();
+
+  return RT_OK;
+}
+
+uint32_t rt_mailbox_read(rt_mailbox_t *mb, void * const item, uint32_t * const seq)
+{
+  // The newest value, without locking. RT_NOK if nothing is written yet.
+  uint32_t newest;
+
+  do {
+    newest = mb->seq;
+    if (newest == 0)
+      return RT_NOK;
+
+    rt_port_barrier();
+
+    rt_queue_copy((uint8_t *) item, mb->buffer + (newest & (mb->slots - 1)) * mb->item_size, mb->item_size);
+
+    rt_port_barrier();
+
+    // Torn if a write to the same slot started while copying
+  } while (mb->started - newest >= mb->slots);
+
+  if (seq != NULL)
+    *seq = newest;
+
+  return RT_OK;
+}
+
+uint32_t rt_mailbox_wait(rt_mailbox_t *mb, void * const item, uint32_t * const seq, const uint32_t ticks_timeout)
+{
+  // Reads once there is a newer value than *seq, and updates it
+  uint32_t value_read = RT_OK;
+
+  rt_enter_critical();
+
+  if (mb->seq == *seq) {
+
+    list_item_t *blocked_list_item = &(current_task->blocked_list_item);
+    uint32_t wait_start = RT_OBJ_WAIT_START();
+
+    // Add currently running task to blocked list
+    blocked_list_item->value = current_task->priority;
+    list_sorted_insert((list_sorted_t *) &(mb->blocked), blocked_list_item);
+
+    RT_TRACE_BLOCK(current_task, mb);
+
+    // Suspend task for ticks_timeout ticks
+    rt_list_task_delayed(current_task, rt_get_tick()+ticks_timeout);
+
+    rt_exit_critical();
+
+    // yields here
+
+    rt_enter_critical();
+
+    RT_LATENCY_WOKEN(current_task);
+
+    // Not blocked anymore, either it was unblocked or it timed out
+    list_sorted_remove(&(current_task->blocked_list_item));
+
+    // Still nothing new?
+    if (mb->seq == *seq)
+      value_read = RT_NOK;
+
+    RT_OBJ_WAITED(&(mb->obj), wait_start, value_read);
+  }
+
+  rt_exit_critical();
+
+  if (value_read == RT_OK) {
+    rt_mailbox_read(mb, item, seq);
+    RT_OBJ_ACQUIRE(&(mb->obj), 1);
+  }
+
+  return value_read;
+}
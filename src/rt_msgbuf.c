@@ -0,0 +1,419 @@
+/*
+ * rt_msgbuf.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_msgbuf.h"
+#include "rt_queue.h"
+#include "rt_kernel.h"
+
+#define RT_MSGBUF_PENDING   (0xFFFE)    // Length of a record not yet committed
+#define RT_MSGBUF_SKIP      (0xFFFF)    // Length of a record to step over
+
+#define RT_MSGBUF_RECORD_SIZE(length) (sizeof(rt_msgbuf_header_t) + (((length) + 3) & ~3u))
+
+typedef struct {
+  uint16_t length;                // Of the message, or one of the above
+  uint16_t size;                  // Of the record, header included
+} rt_msgbuf_header_t;
+
+static rt_msgbuf_header_t * rt_msgbuf_claim(rt_msgbuf_t *mb, const uint32_t size);
+static rt_msgbuf_header_t * rt_msgbuf_oldest(rt_msgbuf_t *mb);
+static rt_msgbuf_header_t * rt_msgbuf_reserve(rt_msgbuf_t *mb, const uint32_t length, const uint32_t ticks_timeout);
+static rt_msgbuf_header_t * rt_msgbuf_next(rt_msgbuf_t *mb, const uint32_t ticks_timeout);
+static uint32_t rt_msgbuf_commit(rt_msgbuf_t *mb, rt_msgbuf_header_t *header, const uint32_t length);
+static uint32_t rt_msgbuf_release(rt_msgbuf_t *mb);
+static uint32_t rt_msgbuf_wait(rt_msgbuf_t *mb, list_sorted_t *blocked, const uint32_t wake_up_tick);
+static uint32_t rt_msgbuf_unblock(rt_msgbuf_t *mb, list_sorted_t *blocked);
+static uint32_t rt_msgbuf_unblock_senders(rt_msgbuf_t *mb);
+
+uint32_t rt_msgbuf_init(rt_msgbuf_t *mb, uint8_t *buffer, uint32_t size)
+{
+  if (((uint32_t) (uintptr_t) buffer & 3) != 0)
+    return RT_NOK;
+
+  if (size > 0xFFFC)
+    size = 0xFFFC;
+
+  mb->buffer = buffer;
+  mb->size = size & ~3u;
+  mb->head = 0;
+  mb->tail = 0;
+  mb->used = 0;
+  mb->messages = 0;
+
+  list_sorted_init((list_sorted_t *) &(mb->blocked_send));
+  list_sorted_init((list_sorted_t *) &(mb->blocked_receive));
+
+  RT_LATENCY_INIT(&(mb->latency));
+  RT_OBJ_REGISTER(&(mb->obj), RT_OBJ_MSGBUF);
+
+  return RT_OK;
+}
+
+uint32_t rt_msgbuf_send(rt_msgbuf_t *mb, const void * const data, const uint32_t length, const uint32_t ticks_timeout)
+{
+  rt_msgbuf_header_t *header;
+  uint32_t message_sent = RT_NOK;
+
+  rt_enter_critical();
+
+  header = rt_msgbuf_reserve(mb, length, ticks_timeout);
+
+  rt_exit_critical();
+
+  if (header != NULL) {
+    // Copy outside the critical section, the record is ours
+    rt_queue_copy((uint8_t *) (header + 1), (const uint8_t *) data, length);
+    rt_msgbuf_send_commit(mb, header + 1, length);
+    message_sent = RT_OK;
+  }
+
+  return message_sent;
+}
+
+uint32_t rt_msgbuf_send_from_isr(rt_msgbuf_t *mb, const void * const data, const uint32_t length)
+{
+  rt_msgbuf_header_t *header;
+  uint32_t task_unblocked = RT_NOK;
+
+  rt_enter_critical();
+
+  header = rt_msgbuf_reserve(mb, length, 0);
+
+  if (header != NULL) {
+    rt_queue_copy((uint8_t *) (header + 1), (const uint8_t *) data, length);
+    task_unblocked = rt_msgbuf_commit(mb, header, length);
+  }
+
+  rt_exit_critical();
+
+  return task_unblocked;
+}
+
+uint32_t rt_msgbuf_receive(rt_msgbuf_t *mb, void * const data, const uint32_t max_length, const uint32_t ticks_timeout)
+{
+  // Returns the length of the message, of which at most max_length bytes
+  // are copied, or 0 if there was none
+  rt_msgbuf_header_t *header;
+  uint32_t length = 0;
+  uint32_t higher_prio_task_unblocked;
+
+  rt_enter_critical();
+
+  header = rt_msgbuf_next(mb, ticks_timeout);
+
+  if (header != NULL) {
+    length = header->length;
+    rt_queue_copy((uint8_t *) data, (const uint8_t *) (header + 1), (length < max_length) ? length : max_length);
+
+    higher_prio_task_unblocked = rt_msgbuf_release(mb);
+
+    if (higher_prio_task_unblocked != RT_NOK)
+      rt_pend_yield();
+  }
+
+  rt_exit_critical();
+
+  return length;
+}
+
+void * rt_msgbuf_send_reserve(rt_msgbuf_t *mb, const uint32_t length, const uint32_t ticks_timeout)
+{
+  rt_msgbuf_header_t *header;
+
+  rt_enter_critical();
+
+  header = rt_msgbuf_reserve(mb, length, ticks_timeout);
+
+  rt_exit_critical();
+
+  return (header != NULL) ? (void *) (header + 1) : NULL;
+}
+
+void rt_msgbuf_send_commit(rt_msgbuf_t *mb, void * const data, const uint32_t length)
+{
+  // Up to the reserved length, 0 drops the message
+  rt_msgbuf_header_t *header = (rt_msgbuf_header_t *) data - 1;
+
+  rt_enter_critical();
+
+  if (rt_msgbuf_commit(mb, header, length) != RT_NOK)
+    rt_pend_yield();
+
+  rt_exit_critical();
+}
+
+void * rt_msgbuf_receive_reserve(rt_msgbuf_t *mb, uint32_t * const length, const uint32_t ticks_timeout)
+{
+  rt_msgbuf_header_t *header;
+
+  rt_enter_critical();
+
+  header = rt_msgbuf_next(mb, ticks_timeout);
+
+  rt_exit_critical();
+
+  if (header == NULL)
+    return NULL;
+
+  *length = header->length;
+
+  return (void *) (header + 1);
+}
+
+void rt_msgbuf_receive_release(rt_msgbuf_t *mb)
+{
+  rt_enter_critical();
+
+  if (rt_msgbuf_release(mb) != RT_NOK)
+    rt_pend_yield();
+
+  rt_exit_critical();
+}
+
+static rt_msgbuf_header_t * rt_msgbuf_claim(rt_msgbuf_t *mb, const uint32_t size)
+{
+  // Room for a record of size bytes in one piece at head, or NULL
+  rt_msgbuf_header_t *header;
+
+  if (mb->used == 0) {
+    // Empty, so start over where there is the most room in one piece
+    mb->head = 0;
+    mb->tail = 0;
+  }
+
+  if (mb->head < mb->tail) {
+    if (size > mb->tail - mb->head)
+      return NULL;
+
+  } else if (mb->used < mb->size && size > mb->size - mb->head) {
+    if (size > mb->tail)
+      return NULL;
+
+    // Not enough room before the end, so skip it and wrap around
+    header = (rt_msgbuf_header_t *) (mb->buffer + mb->head);
+    header->length = RT_MSGBUF_SKIP;
+    header->size = mb->size - mb->head;
+    mb->used += header->size;
+    mb->head = 0;
+
+  } else if (mb->used == mb->size) {
+    return NULL;
+  }
+
+  header = (rt_msgbuf_header_t *) (mb->buffer + mb->head);
+  header->length = RT_MSGBUF_PENDING;
+  header->size = size;
+
+  mb->used += size;
+  mb->head += size;
+  if (mb->head == mb->size)
+    mb->head = 0;
+
+  return header;
+}
+
+static rt_msgbuf_header_t * rt_msgbuf_oldest(rt_msgbuf_t *mb)
+{
+  // The oldest message if it is committed, or NULL
+  rt_msgbuf_header_t *header;
+
+  while (mb->used > 0) {
+    header = (rt_msgbuf_header_t *) (mb->buffer + mb->tail);
+
+    if (header->length == RT_MSGBUF_PENDING)
+      return NULL;
+
+    if (header->length != RT_MSGBUF_SKIP)
+      return header;
+
+    mb->used -= header->size;
+    mb->tail += header->size;
+    if (mb->tail == mb->size)
+      mb->tail = 0;
+  }
+
+  return NULL;
+}
+
+static rt_msgbuf_header_t * rt_msgbuf_reserve(rt_msgbuf_t *mb, const uint32_t length, const uint32_t ticks_timeout)
+{
+  // In a critical section, which is left while blocked
+  rt_msgbuf_header_t *header;
+  uint32_t size = RT_MSGBUF_RECORD_SIZE(length);
+  uint32_t wake_up_tick = rt_get_tick() + ticks_timeout;
+  uint32_t wait_start = 0;
+  uint32_t contended = 0;
+
+  if (length == 0 || size > mb->size)
+    return NULL;
+
+  while ((header = rt_msgbuf_claim(mb, size)) == NULL) {
+    if (!contended) {
+      contended = 1;
+      wait_start = RT_OBJ_WAIT_START();
+    }
+
+    if (rt_msgbuf_wait(mb, (list_sorted_t *) &(mb->blocked_send), wake_up_tick) != RT_OK)
+      break;
+  }
+
+  if (contended)
+    RT_OBJ_WAITED(&(mb->obj), wait_start, (header != NULL) ? RT_OK : RT_NOK);
+
+  return header;
+}
+
+static rt_msgbuf_header_t * rt_msgbuf_next(rt_msgbuf_t *mb, const uint32_t ticks_timeout)
+{
+  // The oldest message, waiting for it if needed. In a critical section,
+  // which is left while blocked.
+  rt_msgbuf_header_t *header;
+  uint32_t wake_up_tick = rt_get_tick() + ticks_timeout;
+  uint32_t wait_start = 0;
+  uint32_t contended = 0;
+
+  while ((header = rt_msgbuf_oldest(mb)) == NULL) {
+    if (!contended) {
+      contended = 1;
+      wait_start = RT_OBJ_WAIT_START();
+    }
+
+    if (rt_msgbuf_wait(mb, (list_sorted_t *) &(mb->blocked_receive), wake_up_tick) != RT_OK)
+      break;
+  }
+
+  if (contended)
+    RT_OBJ_WAITED(&(mb->obj), wait_start, (header != NULL) ? RT_OK : RT_NOK);
+
+  return header;
+}
+
+static uint32_t rt_msgbuf_commit(rt_msgbuf_t *mb, rt_msgbuf_header_t *header, const uint32_t length)
+{
+  // In a critical section. RT_OK if a task of higher prio was unblocked.
+  uint32_t task_unblocked = RT_NOK;
+  uint32_t used = mb->used;
+
+  if (length == 0 || RT_MSGBUF_RECORD_SIZE(length) > header->size) {
+    // Dropped. Its room is freed now if it is the oldest, or else along
+    // with the message before it.
+    header->length = RT_MSGBUF_SKIP;
+
+    rt_msgbuf_oldest(mb);
+    if (mb->used < used)
+      task_unblocked = rt_msgbuf_unblock_senders(mb);
+  } else {
+    header->length = length;
+
+    (mb->messages)++;
+
+    RT_OBJ_ACQUIRE(&(mb->obj), mb->messages);
+  }
+
+  // It may have held up messages after it
+  if (LIST_LENGTH(&(mb->blocked_receive)) > 0 && rt_msgbuf_oldest(mb) != NULL) {
+    if (rt_msgbuf_unblock(mb, (list_sorted_t *) &(mb->blocked_receive)) == RT_OK)
+      task_unblocked = RT_OK;
+  }
+
+  return task_unblocked;
+}
+
+static uint32_t rt_msgbuf_release(rt_msgbuf_t *mb)
+{
+  // Frees the oldest message, in a critical section. RT_OK if a task of
+  // higher prio was unblocked.
+  rt_msgbuf_header_t *header = rt_msgbuf_oldest(mb);
+  uint32_t task_unblocked = RT_NOK;
+
+  if (header == NULL)
+    return RT_NOK;
+
+  mb->used -= header->size;
+  mb->tail += header->size;
+  if (mb->tail == mb->size)
+    mb->tail = 0;
+
+  (mb->messages)--;
+
+  RT_OBJ_ACQUIRE(&(mb->obj), mb->messages);
+
+  // Also free the skipped end and dropped messages that follow, so that
+  // the senders see all the room there is
+  rt_msgbuf_oldest(mb);
+
+  task_unblocked = rt_msgbuf_unblock_senders(mb);
+
+  // One more for the next receiver
+  if (LIST_LENGTH(&(mb->blocked_receive)) > 0 && rt_msgbuf_oldest(mb) != NULL) {
+    if (rt_msgbuf_unblock(mb, (list_sorted_t *) &(mb->blocked_receive)) == RT_OK)
+      task_unblocked = RT_OK;
+  }
+
+  return task_unblocked;
+}
+
+static uint32_t rt_msgbuf_wait(rt_msgbuf_t *mb, list_sorted_t *blocked, const uint32_t wake_up_tick)
+{
+  // Blocks in a critical section until unblocked or wake_up_tick. RT_NOK
+  // if that has passed already, or if called from an ISR.
+  list_item_t *blocked_list_item = &(current_task->blocked_list_item);
+
+  if (rt_port_active_irq() || (int32_t) (wake_up_tick - rt_get_tick()) <= 0)
+    return RT_NOK;
+
+  // Add currently running task to blocked list
+  blocked_list_item->value = current_task->priority;
+  list_sorted_insert(blocked, blocked_list_item);
+
+  RT_TRACE_BLOCK(current_task, mb);
+
+  rt_list_task_delayed(current_task, wake_up_tick);
+
+  rt_exit_critical();
+
+  // yields here
+
+  rt_enter_critical();
+
+  RT_LATENCY_WOKEN(current_task);
+
+  // Not blocked anymore, either it was unblocked or it timed out
+  list_sorted_remove(blocked_list_item);
+
+  return RT_OK;
+}
+
+static uint32_t rt_msgbuf_unblock(rt_msgbuf_t *mb, list_sorted_t *blocked)
+{
+  // Unblock the highest prio blocked task
+  rt_task_t unblocked_task = (rt_task_t) LIST_MAX_VALUE_REF(blocked);
+  list_sorted_remove((list_item_t *) &(unblocked_task->blocked_list_item));
+  rt_list_task_undelayed(unblocked_task);
+  rt_list_task_ready_next(unblocked_task);
+
+  RT_TRACE_UNBLOCK(unblocked_task, mb);
+  RT_LATENCY_GIVE(unblocked_task, &(mb->latency));
+
+  if (unblocked_task->priority >= current_task->priority)
+    return RT_OK;
+  else
+    return RT_NOK;
+}
+
+static uint32_t rt_msgbuf_unblock_senders(rt_msgbuf_t *mb)
+{
+  // The senders need different amounts of room, so let them all try again
+  uint32_t task_unblocked = RT_NOK;
+
+  while (LIST_LENGTH(&(mb->blocked_send)) > 0) {
+    if (rt_msgbuf_unblock(mb, (list_sorted_t *) &(mb->blocked_send)) == RT_OK)
+      task_unblocked = RT_OK;
+  }
+
+  return task_unblocked;
+}
@@ -0,0 +1,103 @@
+/*
+ * rt_obj.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_kernel.h"
+#include "rt_obj.h"
+
+#if RT_OBJ_STATS_ENABLE
+
+static rt_obj_t *obj_list = NULL;
+
+static void rt_obj_clear(rt_obj_stats_t *stats)
+{
+  stats->acquisitions = 0;
+  stats->contended = 0;
+  stats->timeouts = 0;
+  stats->wait_max = 0;
+  stats->wait_sum = 0;
+  stats->max_depth = 0;
+}
+
+void rt_obj_register(rt_obj_t * const obj, const uint32_t type)
+{
+  rt_obj_t *registered;
+
+  rt_enter_critical();
+
+  // An object may be initialized more than once
+  for (registered = obj_list; registered != NULL; registered = registered->next_obj) {
+    if (registered == obj)
+      break;
+  }
+
+  if (registered == NULL) {
+    obj->name = NULL;
+    obj->next_obj = obj_list;
+    obj_list = obj;
+  }
+
+  obj->type = type;
+  rt_obj_clear(&(obj->stats));
+
+  rt_exit_critical();
+}
+
+// The hooks below are called by the kernel objects within their critical sections
+
+void rt_obj_acquire(rt_obj_t * const obj, const uint32_t depth)
+{
+  obj->stats.acquisitions++;
+
+  rt_obj_depth(obj, depth);
+}
+
+void rt_obj_depth(rt_obj_t * const obj, const uint32_t depth)
+{
+  if (depth > obj->stats.max_depth)
+    obj->stats.max_depth = depth;
+}
+
+void rt_obj_waited(rt_obj_t * const obj, const uint32_t start, const uint32_t acquired)
+{
+  uint32_t cycles = rt_get_cycles() - start;
+
+  obj->stats.contended++;
+  obj->stats.wait_sum += cycles;
+
+  if (cycles > obj->stats.wait_max)
+    obj->stats.wait_max = cycles;
+
+  if (acquired == RT_NOK)
+    obj->stats.timeouts++;
+}
+
+void rt_obj_set_name(rt_obj_t * const obj, const char *name)
+{
+  obj->name = name;
+}
+
+rt_obj_t * rt_obj_list(void)
+{
+  // Iterate using obj->next_obj
+  return obj_list;
+}
+
+void rt_obj_stats_get(rt_obj_t * const obj, rt_obj_stats_t *stats)
+{
+  rt_enter_critical();
+  *stats = obj->stats;
+  rt_exit_critical();
+}
+
+void rt_obj_stats_reset(rt_obj_t * const obj)
+{
+  rt_enter_critical();
+  rt_obj_clear(&(obj->stats));
+  rt_exit_critical();
+}
+
+#endif
@@ -0,0 +1,248 @@
+/*
+ * rt_prio_queue.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_prio_queue.h"
+#include "rt_queue.h"
+#include "rt_kernel.h"
+
+static uint32_t rt_prio_queue_unblock(rt_prio_queue_t *queue, list_sorted_t *blocked);
+
+uint32_t rt_prio_queue_init(rt_prio_queue_t *queue, uint8_t *buffer, uint32_t item_size, uint32_t max_items)
+{
+  uint32_t slot;
+  uint32_t prio;
+
+  if (max_items == 0 || max_items >= RT_PRIO_QUEUE_END)
+    return RT_NOK;
+
+  queue->buffer = buffer;
+  queue->link = (uint16_t *) (buffer + ((item_size * max_items + 1) & ~1u));
+  queue->item_size = item_size;
+  queue->max_items = max_items;
+  queue->items = 0;
+  queue->levels = 0;
+
+  for (prio = 0; prio < RT_PRIO_QUEUE_LEVELS; prio++) {
+    queue->head[prio] = RT_PRIO_QUEUE_END;
+    queue->tail[prio] = RT_PRIO_QUEUE_END;
+  }
+
+  // All slots are free
+  for (slot = 0; slot < max_items - 1; slot++)
+    queue->link[slot] = slot + 1;
+  queue->link[max_items - 1] = RT_PRIO_QUEUE_END;
+  queue->free = 0;
+
+  list_sorted_init((list_sorted_t *) &(queue->blocked_push));
+  list_sorted_init((list_sorted_t *) &(queue->blocked_pull));
+
+  RT_LATENCY_INIT(&(queue->latency));
+  RT_OBJ_REGISTER(&(queue->obj), RT_OBJ_QUEUE);
+
+  return RT_OK;
+}
+
+uint32_t rt_prio_queue_push_from_isr(rt_prio_queue_t *queue, const void * const item, const uint32_t prio)
+{
+  uint32_t slot;
+  uint32_t task_unblocked = RT_NOK;
+
+  if (prio >= RT_PRIO_QUEUE_LEVELS)
+    return RT_NOK;
+
+  rt_enter_critical();
+
+  if (queue->free != RT_PRIO_QUEUE_END) {
+
+    slot = queue->free;
+    queue->free = queue->link[slot];
+
+    rt_queue_copy(queue->buffer + slot * queue->item_size, (const uint8_t *) item, queue->item_size);
+
+    // Last in the list of its prio
+    queue->link[slot] = RT_PRIO_QUEUE_END;
+    if (queue->head[prio] == RT_PRIO_QUEUE_END)
+      queue->head[prio] = slot;
+    else
+      queue->link[queue->tail[prio]] = slot;
+    queue->tail[prio] = slot;
+
+    queue->levels |= (1u << prio);
+    (queue->items)++;
+
+    RT_OBJ_ACQUIRE(&(queue->obj), queue->items);
+
+    if (LIST_LENGTH(&(queue->blocked_pull)) > 0)
+      task_unblocked = rt_prio_queue_unblock(queue, (list_sorted_t *) &(queue->blocked_pull));
+  }
+
+  rt_exit_critical();
+
+  return task_unblocked;
+}
+
+uint32_t rt_prio_queue_push(rt_prio_queue_t *queue, const void * const item, const uint32_t prio, const uint32_t ticks_timeout)
+{
+  uint32_t item_pushed = RT_OK;
+  uint32_t higher_prio_task_unblocked = RT_NOK;
+
+  if (prio >= RT_PRIO_QUEUE_LEVELS)
+    return RT_NOK;
+
+  rt_enter_critical();
+
+  if (queue->free == RT_PRIO_QUEUE_END) {
+
+    list_item_t *blocked_list_item = &(current_task->blocked_list_item);
+    uint32_t wait_start = RT_OBJ_WAIT_START();
+
+    // Add currently running task to blocked list
+    blocked_list_item->value = current_task->priority;
+    list_sorted_insert((list_sorted_t *) &(queue->blocked_push), blocked_list_item);
+
+    RT_TRACE_BLOCK(current_task, queue);
+
+    // Suspend task for ticks_timeout ticks
+    rt_list_task_delayed(current_task, rt_get_tick()+ticks_timeout);
+
+    rt_exit_critical();
+
+    // yields here
+
+    rt_enter_critical();
+
+    RT_LATENCY_WOKEN(current_task);
+
+    // Not blocked anymore, either it was unblocked or it timed out
+    list_sorted_remove(&(current_task->blocked_list_item));
+
+    // Is it still full?
+    if (queue->free == RT_PRIO_QUEUE_END)
+      item_pushed = RT_NOK;
+    else
+      higher_prio_task_unblocked = rt_prio_queue_push_from_isr(queue, item, prio);
+
+    RT_OBJ_WAITED(&(queue->obj), wait_start, item_pushed);
+
+  } else {
+    higher_prio_task_unblocked = rt_prio_queue_push_from_isr(queue, item, prio);
+  }
+
+  if (higher_prio_task_unblocked != RT_NOK)
+    rt_pend_yield();
+
+  rt_exit_critical();
+
+  return item_pushed;
+}
+
+uint32_t rt_prio_queue_pull_from_isr(rt_prio_queue_t *queue, void * const item)
+{
+  uint32_t slot;
+  uint32_t prio;
+  uint32_t task_unblocked = RT_NOK;
+
+  rt_enter_critical();
+
+  if (queue->levels != 0) {
+
+    // First in the list of the highest prio
+    prio = 31 - __builtin_clz(queue->levels);
+    slot = queue->head[prio];
+
+    rt_queue_copy((uint8_t *) item, queue->buffer + slot * queue->item_size, queue->item_size);
+
+    queue->head[prio] = queue->link[slot];
+    if (queue->head[prio] == RT_PRIO_QUEUE_END) {
+      queue->tail[prio] = RT_PRIO_QUEUE_END;
+      queue->levels &= ~(1u << prio);
+    }
+
+    queue->link[slot] = queue->free;
+    queue->free = slot;
+
+    (queue->items)--;
+
+    RT_OBJ_ACQUIRE(&(queue->obj), queue->items);
+
+    if (LIST_LENGTH(&(queue->blocked_push)) > 0)
+      task_unblocked = rt_prio_queue_unblock(queue, (list_sorted_t *) &(queue->blocked_push));
+  }
+
+  rt_exit_critical();
+
+  return task_unblocked;
+}
+
+uint32_t rt_prio_queue_pull(rt_prio_queue_t *queue, void * const item, const uint32_t ticks_timeout)
+{
+  uint32_t item_pulled = RT_OK;
+  uint32_t higher_prio_task_unblocked = RT_NOK;
+
+  rt_enter_critical();
+
+  if (queue->levels == 0) {
+
+    list_item_t *blocked_list_item = &(current_task->blocked_list_item);
+    uint32_t wait_start = RT_OBJ_WAIT_START();
+
+    // Add currently running task to blocked list
+    blocked_list_item->value = current_task->priority;
+    list_sorted_insert((list_sorted_t *) &(queue->blocked_pull), blocked_list_item);
+
+    RT_TRACE_BLOCK(current_task, queue);
+
+    // Suspend task for ticks_timeout ticks
+    rt_list_task_delayed(current_task, rt_get_tick()+ticks_timeout);
+
+    rt_exit_critical();
+
+    // yields here
+
+    rt_enter_critical();
+
+    RT_LATENCY_WOKEN(current_task);
+
+    // Not blocked anymore, either it was unblocked or it timed out
+    list_sorted_remove(&(current_task->blocked_list_item));
+
+    // Is it still empty?
+    if (queue->levels == 0)
+      item_pulled = RT_NOK;
+    else
+      higher_prio_task_unblocked = rt_prio_queue_pull_from_isr(queue, item);
+
+    RT_OBJ_WAITED(&(queue->obj), wait_start, item_pulled);
+
+  } else {
+    higher_prio_task_unblocked = rt_prio_queue_pull_from_isr(queue, item);
+  }
+
+  if (higher_prio_task_unblocked != RT_NOK)
+    rt_pend_yield();
+
+  rt_exit_critical();
+
+  return item_pulled;
+}
+
+static uint32_t rt_prio_queue_unblock(rt_prio_queue_t *queue, list_sorted_t *blocked)
+{
+  // Unblock the highest prio blocked task
+  rt_task_t unblocked_task = (rt_task_t) LIST_MAX_VALUE_REF(blocked);
+  list_sorted_remove((list_item_t *) &(unblocked_task->blocked_list_item));
+  rt_list_task_undelayed(unblocked_task);
+  rt_list_task_ready_next(unblocked_task);
+
+  RT_TRACE_UNBLOCK(unblocked_task, queue);
+  RT_LATENCY_GIVE(unblocked_task, &(queue->latency));
+
+  if (unblocked_task->priority >= current_task->priority)
+    return RT_OK;
+  else
+    return RT_NOK;
+}
@@ -0,0 +1,137 @@
+/*
+ * rt_prof.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_kernel.h"
+#include "rt_prof.h"
+
+#if RT_PROF_ENABLE
+
+#define RT_PROF_SLOT_MASK (RT_PROF_SLOTS-1)
+
+rt_prof_t rt_prof;
+
+static TIM_HandleTypeDef prof_timer;
+
+void rt_prof_sample(const uint32_t *frame) __attribute__((used));
+void RT_PROF_IRQHandler(void) __attribute__((naked));
+
+void rt_prof_sample(const uint32_t *frame)
+{
+  // Exception stack frame: r0, r1, r2, r3, r12, lr, pc, xpsr
+  uint32_t pc = frame[6];
+  uint32_t exception = frame[7] & 0x1FF;
+  uint32_t context = exception ? exception : (uint32_t) current_task;
+  uint32_t probe, index;
+  rt_prof_slot_t *slot;
+
+  RT_PROF_TIM->SR = ~TIM_SR_UIF;
+
+  rt_prof.samples++;
+
+  index = ((pc >> 1) ^ (context * 2654435761u)) & RT_PROF_SLOT_MASK;
+
+  for (probe = 0; probe < RT_PROF_MAX_PROBES; probe++) {
+    slot = &(rt_prof.slot[index]);
+
+    if (slot->count == 0) {
+      slot->pc = pc;
+      slot->context = context;
+      slot->count = 1;
+      return;
+    }
+
+    if (slot->pc == pc && slot->context == context) {
+      slot->count++;
+      return;
+    }
+
+    index = (index + 1) & RT_PROF_SLOT_MASK;
+  }
+
+  rt_prof.dropped++;
+}
+
+void RT_PROF_IRQHandler(void)
+{
+  // Pass the stack frame of the interrupted context, the same way as when
+  // digging out registers in a fault handler. rt_prof_sample returns directly
+  // to the interrupted context.
+  __asm volatile (
+    " tst lr, #4                \n\t"
+    " ite eq                    \n\t"
+    " mrseq r0, msp             \n\t"
+    " mrsne r0, psp             \n\t"
+    " b rt_prof_sample          \n\t"
+  );
+}
+
+void rt_prof_reset(void)
+{
+  uint32_t i;
+
+  HAL_NVIC_DisableIRQ(RT_PROF_IRQn);
+
+  for (i = 0; i < RT_PROF_SLOTS; i++) {
+    rt_prof.slot[i].pc = 0;
+    rt_prof.slot[i].context = 0;
+    rt_prof.slot[i].count = 0;
+  }
+
+  rt_prof.samples = 0;
+  rt_prof.dropped = 0;
+
+  if (prof_timer.Instance != NULL)
+    HAL_NVIC_EnableIRQ(RT_PROF_IRQn);
+}
+
+uint32_t rt_prof_start(const uint32_t sample_hz)
+{
+  uint32_t timer_clk = HAL_RCC_GetPCLK1Freq();
+
+  // APB1 timers run at twice the bus clock when it is prescaled
+  if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+    timer_clk *= 2;
+
+  if (sample_hz == 0 || sample_hz > timer_clk)
+    return RT_NOK;
+
+  rt_prof_stop();
+
+  rt_prof.magic = RT_PROF_MAGIC;
+  rt_prof.version = RT_PROF_VERSION;
+  rt_prof.slots = RT_PROF_SLOTS;
+  rt_prof.sample_hz = sample_hz;
+  rt_prof_reset();
+
+  RT_PROF_TIM_CLK_ENABLE();
+
+  prof_timer.Instance = RT_PROF_TIM;
+  prof_timer.Init.CounterMode = TIM_COUNTERMODE_UP;
+  prof_timer.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  prof_timer.Init.Prescaler = 0;
+  prof_timer.Init.Period = timer_clk / sample_hz - 1;
+  HAL_TIM_Base_Init(&prof_timer);
+
+  __HAL_TIM_SET_COUNTER(&prof_timer, 0);
+
+  HAL_NVIC_SetPriority(RT_PROF_IRQn, RT_PROF_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(RT_PROF_IRQn);
+
+  HAL_TIM_Base_Start_IT(&prof_timer);
+
+  return RT_OK;
+}
+
+void rt_prof_stop(void)
+{
+  if (prof_timer.Instance != NULL) {
+    HAL_TIM_Base_Stop_IT(&prof_timer);
+    HAL_NVIC_DisableIRQ(RT_PROF_IRQn);
+  }
+}
+
+#endif
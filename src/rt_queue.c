@@ -8,6 +8,112 @@
 #include "rt_queue.h"
 #include "rt_kernel.h"
 
+static uint32_t rt_queue_push_wait(rt_queue_t *queue, const void * const item, const uint32_t ticks_timeout, uint32_t (*push_from_isr)(rt_queue_t *, const void * const));
+
+void rt_queue_copy(uint8_t *dst, const uint8_t *src, uint32_t size)
+{
+  // Whole words when both sides allow it, which is always the case for
+  // the C++ rt::Queue
+  if ((((uint32_t) (uintptr_t) dst | (uint32_t) (uintptr_t) src | size) & 3) == 0) {
+    uint32_t *dst_word = (uint32_t *) dst;
+    const uint32_t *src_word = (const uint32_t *) src;
+
+    for (size >>= 2; size > 0; size--)
+      *dst_word++ = *src_word++;
+  } else {
+    while (size--)
+      *dst++ = *src++;
+  }
+}
+
+static uint32_t rt_queue_unblock(rt_queue_t *queue, list_sorted_t *blocked)
+{
+  // Unblock the highest prio blocked task
+  rt_task_t unblocked_task = (rt_task_t) LIST_MAX_VALUE_REF(blocked);
+  list_sorted_remove((list_item_t *) &(unblocked_task->blocked_list_item));
+  rt_list_task_undelayed(unblocked_task);
+  rt_list_task_ready_next(unblocked_task);
+
+  RT_TRACE_UNBLOCK(unblocked_task, queue);
+  RT_LATENCY_GIVE(unblocked_task, &(queue->latency));
+
+  if (unblocked_task->priority >= current_task->priority)
+    return RT_OK;
+  else
+    return RT_NOK;
+}
+
+static uint32_t rt_queue_filled(rt_queue_t *queue)
+{
+  // Below what the pullers sleep on, they sleep until their timeout.
+  // Without any, a waitset is signalled at the threshold.
+  if (LIST_LENGTH(&(queue->blocked_pull)) > 0) {
+    if (queue->items >= queue->pull_wait)
+      return rt_queue_unblock(queue, (list_sorted_t *) &(queue->blocked_pull));
+  } else if (queue->items >= queue->threshold) {
+    return RT_WAITSET_SIGNAL(&(queue->waitset));
+  }
+
+  return RT_NOK;
+}
+
+static void rt_queue_pull_wait_for(rt_queue_t *queue, const uint32_t wait_for)
+{
+  // Called before blocking. The blocked pullers are woken at the least
+  // any of them waits for, the others just get fewer items.
+  if (LIST_LENGTH(&(queue->blocked_pull)) == 0 || wait_for < queue->pull_wait)
+    queue->pull_wait = wait_for;
+}
+
+static uint32_t rt_queue_pushed(rt_queue_t *queue)
+{
+  // One more item is in place. RT_OK if a task of higher prio was unblocked.
+  (queue->items)++;
+
+  RT_OBJ_ACQUIRE(&(queue->obj), queue->items);
+
+  return rt_queue_filled(queue);
+}
+
+static void rt_queue_read(rt_queue_t *queue, uint8_t *dst, const uint32_t n)
+{
+  // The n oldest items, in two chunks if they wrap around
+  uint32_t size = n * queue->item_size;
+  uint32_t chunk = (uint32_t) (queue->buffer_end + 1 - queue->old);
+
+  if (chunk > size)
+    chunk = size;
+
+  rt_queue_copy(dst, queue->old, chunk);
+  rt_queue_copy(dst + chunk, queue->buffer_start, size - chunk);
+
+  if (chunk < size)
+    queue->old = queue->buffer_start + (size - chunk);
+  else if ((queue->old += size) > queue->buffer_end)
+    queue->old = queue->buffer_start;
+
+  queue->items -= n;
+}
+
+static void rt_queue_write(rt_queue_t *queue, const uint8_t *src, const uint32_t n)
+{
+  // As rt_queue_read, for n items that there is room for
+  uint32_t size = n * queue->item_size;
+  uint32_t chunk = (uint32_t) (queue->buffer_end + 1 - queue->next);
+
+  if (chunk > size)
+    chunk = size;
+
+  rt_queue_copy(queue->next, src, chunk);
+  rt_queue_copy(queue->buffer_start, src + chunk, size - chunk);
+
+  if (chunk < size)
+    queue->next = queue->buffer_start + (size - chunk);
+  else if ((queue->next += size) > queue->buffer_end)
+    queue->next = queue->buffer_start;
+
+  queue->items += n;
+}
 
 uint32_t rt_queue_init(rt_queue_t *queue, uint8_t *buffer, uint32_t item_size, uint32_t max_items)
 {
@@ -18,10 +124,17 @@ uint32_t rt_queue_init(rt_queue_t *queue, uint8_t *buffer, uint32_t item_size, u
   queue->item_size = item_size;
   queue->max_items = max_items;
   queue->items = 0;
+  queue->threshold = 1;
+  queue->pull_wait = 1;
+
+  RT_WAITSET_LINK_INIT(&(queue->waitset));
 
   list_sorted_init((list_sorted_t *) &(queue->blocked_push));
   list_sorted_init((list_sorted_t *) &(queue->blocked_pull));
 
+  RT_LATENCY_INIT(&(queue->latency));
+  RT_OBJ_REGISTER(&(queue->obj), RT_OBJ_QUEUE);
+
   return RT_OK;
 }
 
@@ -30,38 +143,46 @@ uint32_t rt_queue_push_from_isr(rt_queue_t *queue, const void * const item)
   // Assumption: buffer size MUST be item_size*max_items
 
   uint8_t *queue_buffer;
-  uint8_t *item_data;
-  uint32_t cnt, task_unblocked = RT_NOK;
+  uint32_t task_unblocked = RT_NOK;
 
   rt_enter_critical();
 
   if (RT_QUEUE_FULL(queue) == 0) {
 
     // Do that funky copying!
-    queue_buffer = queue->next;
-    item_data = (uint8_t *) item;
-    cnt = queue->item_size;
-
-    while (cnt--)
-      *queue_buffer++ = *item_data++;
+    rt_queue_copy(queue->next, (const uint8_t *) item, queue->item_size);
+    queue_buffer = queue->next + queue->item_size;
 
     if (queue_buffer > queue->buffer_end)
       queue->next = queue->buffer_start;
     else
       queue->next = queue_buffer;
-    
-    (queue->items)++;
 
-    if (LIST_LENGTH(&(queue->blocked_pull)) > 0) {
-      // Unblock the highest prio blocked task
-      rt_task_t unblocked_task = (rt_task_t) LIST_MAX_VALUE_REF(&(queue->blocked_pull));
-      list_sorted_remove((list_item_t *) &(unblocked_task->blocked_list_item));
-      rt_list_task_undelayed(unblocked_task);
-      rt_list_task_ready_next(unblocked_task);
+    task_unblocked = rt_queue_pushed(queue);
+  }
 
-      if (unblocked_task->priority >= current_task->priority)
-        task_unblocked = RT_OK;
-    }
+  rt_exit_critical();
+
+  return task_unblocked;
+}
+
+uint32_t rt_queue_push_front_from_isr(rt_queue_t *queue, const void * const item)
+{
+  // Urgent: ahead of everything else, so it is pulled next
+  uint32_t task_unblocked = RT_NOK;
+
+  rt_enter_critical();
+
+  if (RT_QUEUE_FULL(queue) == 0) {
+
+    if (queue->old == queue->buffer_start)
+      queue->old = queue->buffer_end + 1 - queue->item_size;
+    else
+      queue->old -= queue->item_size;
+
+    rt_queue_copy(queue->old, (const uint8_t *) item, queue->item_size);
+
+    task_unblocked = rt_queue_pushed(queue);
   }
 
   rt_exit_critical();
@@ -70,6 +191,16 @@ uint32_t rt_queue_push_from_isr(rt_queue_t *queue, const void * const item)
 }
 
 uint32_t rt_queue_push(rt_queue_t *queue, const void * const item, const uint32_t ticks_timeout)
+{
+  return rt_queue_push_wait(queue, item, ticks_timeout, rt_queue_push_from_isr);
+}
+
+uint32_t rt_queue_push_front(rt_queue_t *queue, const void * const item, const uint32_t ticks_timeout)
+{
+  return rt_queue_push_wait(queue, item, ticks_timeout, rt_queue_push_front_from_isr);
+}
+
+static uint32_t rt_queue_push_wait(rt_queue_t *queue, const void * const item, const uint32_t ticks_timeout, uint32_t (*push_from_isr)(rt_queue_t *, const void * const))
 {
   // Assumption: buffer size MUST be item_size*max_items
 
@@ -81,11 +212,14 @@ uint32_t rt_queue_push(rt_queue_t *queue, const void * const item, const uint32_
   if (RT_QUEUE_FULL(queue)) {
 
     list_item_t *blocked_list_item = &(current_task->blocked_list_item);
+    uint32_t wait_start = RT_OBJ_WAIT_START();
 
     // Add currently running task to blocked list
     blocked_list_item->value = current_task->priority;
     list_sorted_insert((list_sorted_t *) &(queue->blocked_push), blocked_list_item);
 
+    RT_TRACE_BLOCK(current_task, queue);
+
     // Suspend task for ticks_timeout ticks
     rt_list_task_delayed(current_task, rt_get_tick()+ticks_timeout);
 
@@ -95,6 +229,8 @@ uint32_t rt_queue_push(rt_queue_t *queue, const void * const item, const uint32_
 
     rt_enter_critical();
 
+    RT_LATENCY_WOKEN(current_task);
+
     // Not blocked anymore, either it was unblocked or it timed out
     list_sorted_remove(&(current_task->blocked_list_item));
 
@@ -102,10 +238,12 @@ uint32_t rt_queue_push(rt_queue_t *queue, const void * const item, const uint32_
     if (RT_QUEUE_FULL(queue))
       item_pushed = RT_NOK;
     else
-      higher_prio_task_unblocked = rt_queue_push_from_isr(queue, item);
+      higher_prio_task_unblocked = push_from_isr(queue, item);
+
+    RT_OBJ_WAITED(&(queue->obj), wait_start, item_pushed);
 
   } else {
-    higher_prio_task_unblocked = rt_queue_push_from_isr(queue, item);
+    higher_prio_task_unblocked = push_from_isr(queue, item);
   }
 
   if (higher_prio_task_unblocked != RT_NOK)
@@ -119,20 +257,15 @@ uint32_t rt_queue_push(rt_queue_t *queue, const void * const item, const uint32_
 uint32_t rt_queue_pull_from_isr(rt_queue_t *queue, void * const item)
 {
   uint8_t *queue_buffer;
-  uint8_t *item_data;
-  uint32_t cnt, task_unblocked = RT_NOK;
+  uint32_t task_unblocked = RT_NOK;
 
   rt_enter_critical();
 
   if (RT_QUEUE_EMPTY(queue) == 0) {
 
     // Do that funky copying!
-    queue_buffer = queue->old;
-    item_data = (uint8_t *) item;
-    cnt = queue->item_size;
-
-    while (cnt--)
-      *item_data++ = *queue_buffer++;
+    rt_queue_copy((uint8_t *) item, queue->old, queue->item_size);
+    queue_buffer = queue->old + queue->item_size;
 
     if (queue_buffer > queue->buffer_end)
       queue->old = queue->buffer_start;
@@ -141,16 +274,10 @@ uint32_t rt_queue_pull_from_isr(rt_queue_t *queue, void * const item)
 
     (queue->items)--;
 
-    if (LIST_LENGTH(&(queue->blocked_push)) > 0) {
-      // Unblock the highest prio blocked task
-      rt_task_t unblocked_task = (rt_task_t) LIST_MAX_VALUE_REF(&(queue->blocked_push));
-      list_sorted_remove((list_item_t *) &(unblocked_task->blocked_list_item));
-      rt_list_task_undelayed(unblocked_task);
-      rt_list_task_ready_next(unblocked_task);
+    RT_OBJ_ACQUIRE(&(queue->obj), queue->items);
 
-      if (unblocked_task->priority >= current_task->priority)
-        task_unblocked = RT_OK;
-    }
+    if (LIST_LENGTH(&(queue->blocked_push)) > 0)
+      task_unblocked = rt_queue_unblock(queue, (list_sorted_t *) &(queue->blocked_push));
   } 
 
   rt_exit_critical();
@@ -168,11 +295,16 @@ uint32_t rt_queue_pull(rt_queue_t *queue, void * const item, const uint32_t tick
   if (RT_QUEUE_EMPTY(queue)) {
 
     list_item_t *blocked_list_item = &(current_task->blocked_list_item);
+    uint32_t wait_start = RT_OBJ_WAIT_START();
+
+    rt_queue_pull_wait_for(queue, queue->threshold);
 
     // Add currently running task to blocked list
     blocked_list_item->value = current_task->priority;
     list_sorted_insert((list_sorted_t *) &(queue->blocked_pull), blocked_list_item);
 
+    RT_TRACE_BLOCK(current_task, queue);
+
     // Suspend task for ticks_timeout ticks
     rt_list_task_delayed(current_task, rt_get_tick()+ticks_timeout);
 
@@ -182,6 +314,8 @@ uint32_t rt_queue_pull(rt_queue_t *queue, void * const item, const uint32_t tick
 
     rt_enter_critical();
 
+    RT_LATENCY_WOKEN(current_task);
+
     // Not blocked anymore, either it was unblocked or it timed out
     list_sorted_remove(&(current_task->blocked_list_item));
 
@@ -191,6 +325,8 @@ uint32_t rt_queue_pull(rt_queue_t *queue, void * const item, const uint32_t tick
     else
       higher_prio_task_unblocked = rt_queue_pull_from_isr(queue, item);
 
+    RT_OBJ_WAITED(&(queue->obj), wait_start, item_pulled);
+
   } else {
     higher_prio_task_unblocked = rt_queue_pull_from_isr(queue, item);
   }
@@ -201,4 +337,177 @@ uint32_t rt_queue_pull(rt_queue_t *queue, void * const item, const uint32_t tick
   rt_exit_critical();
 
   return item_pulled;
-}
\ No newline at end of file
+}
+
+uint32_t rt_queue_push_n_from_isr(rt_queue_t *queue, const void * const items, const uint32_t n, uint32_t * const pushed)
+{
+  // As many of the n items as there is room for, *pushed tells how many
+  uint32_t room;
+  uint32_t task_unblocked = RT_NOK;
+
+  rt_enter_critical();
+
+  room = queue->max_items - queue->items;
+  *pushed = (n < room) ? n : room;
+
+  if (*pushed > 0) {
+    rt_queue_write(queue, (const uint8_t *) items, *pushed);
+
+    RT_OBJ_ACQUIRE(&(queue->obj), queue->items);
+
+    // One puller, which is expected to take them all with rt_queue_pull_n
+    task_unblocked = rt_queue_filled(queue);
+  }
+
+  rt_exit_critical();
+
+  return task_unblocked;
+}
+
+uint32_t rt_queue_push_n(rt_queue_t *queue, const void * const items, const uint32_t n, const uint32_t ticks_timeout)
+{
+  // Returns the number of items pushed. Blocks only while the queue is
+  // full, so it may push fewer than n.
+  uint32_t pushed = 0;
+  uint32_t higher_prio_task_unblocked = RT_NOK;
+
+  rt_enter_critical();
+
+  if (RT_QUEUE_FULL(queue) && n > 0) {
+
+    list_item_t *blocked_list_item = &(current_task->blocked_list_item);
+    uint32_t wait_start = RT_OBJ_WAIT_START();
+
+    // Add currently running task to blocked list
+    blocked_list_item->value = current_task->priority;
+    list_sorted_insert((list_sorted_t *) &(queue->blocked_push), blocked_list_item);
+
+    RT_TRACE_BLOCK(current_task, queue);
+
+    // Suspend task for ticks_timeout ticks
+    rt_list_task_delayed(current_task, rt_get_tick()+ticks_timeout);
+
+    rt_exit_critical();
+
+    // yields here
+
+    rt_enter_critical();
+
+    RT_LATENCY_WOKEN(current_task);
+
+    // Not blocked anymore, either it was unblocked or it timed out
+    list_sorted_remove(&(current_task->blocked_list_item));
+
+    RT_OBJ_WAITED(&(queue->obj), wait_start, RT_QUEUE_FULL(queue) ? RT_NOK : RT_OK);
+  }
+
+  higher_prio_task_unblocked = rt_queue_push_n_from_isr(queue, items, n, &pushed);
+
+  if (higher_prio_task_unblocked != RT_NOK)
+    rt_pend_yield();
+
+  rt_exit_critical();
+
+  return pushed;
+}
+
+uint32_t rt_queue_pull_n_from_isr(rt_queue_t *queue, void * const items, const uint32_t max_items, uint32_t * const pulled)
+{
+  // All there are up to max_items, *pulled tells how many
+  uint32_t i;
+  uint32_t task_unblocked = RT_NOK;
+
+  rt_enter_critical();
+
+  *pulled = (queue->items < max_items) ? queue->items : max_items;
+
+  if (*pulled > 0) {
+    rt_queue_read(queue, (uint8_t *) items, *pulled);
+
+    RT_OBJ_ACQUIRE(&(queue->obj), queue->items);
+
+    // Room for that many more, so as many blocked pushers can go on
+    for (i = 0; i < *pulled && LIST_LENGTH(&(queue->blocked_push)) > 0; i++) {
+      if (rt_queue_unblock(queue, (list_sorted_t *) &(queue->blocked_push)) == RT_OK)
+        task_unblocked = RT_OK;
+    }
+  }
+
+  rt_exit_critical();
+
+  return task_unblocked;
+}
+
+uint32_t rt_queue_pull_n(rt_queue_t *queue, void * const items, const uint32_t max_items, const uint32_t ticks_timeout)
+{
+  // Returns the number of items pulled, all there are up to max_items
+  uint32_t pulled = 0;
+  uint32_t wait_for;
+  uint32_t higher_prio_task_unblocked = RT_NOK;
+
+  rt_enter_critical();
+
+  wait_for = (max_items < queue->threshold) ? max_items : queue->threshold;
+
+  if (queue->items < wait_for) {
+
+    list_item_t *blocked_list_item = &(current_task->blocked_list_item);
+    uint32_t wait_start = RT_OBJ_WAIT_START();
+
+    rt_queue_pull_wait_for(queue, wait_for);
+
+    // Add currently running task to blocked list
+    blocked_list_item->value = current_task->priority;
+    list_sorted_insert((list_sorted_t *) &(queue->blocked_pull), blocked_list_item);
+
+    RT_TRACE_BLOCK(current_task, queue);
+
+    // Suspend task for ticks_timeout ticks, or until there are wait_for items
+    rt_list_task_delayed(current_task, rt_get_tick()+ticks_timeout);
+
+    rt_exit_critical();
+
+    // yields here
+
+    rt_enter_critical();
+
+    RT_LATENCY_WOKEN(current_task);
+
+    // Not blocked anymore, either it was unblocked or it timed out
+    list_sorted_remove(&(current_task->blocked_list_item));
+
+    RT_OBJ_WAITED(&(queue->obj), wait_start, RT_QUEUE_EMPTY(queue) ? RT_NOK : RT_OK);
+  }
+
+  higher_prio_task_unblocked = rt_queue_pull_n_from_isr(queue, items, max_items, &pulled);
+
+  if (higher_prio_task_unblocked != RT_NOK)
+    rt_pend_yield();
+
+  rt_exit_critical();
+
+  return pulled;
+}
+
+uint32_t rt_queue_set_threshold(rt_queue_t *queue, uint32_t threshold)
+{
+  if (threshold == 0 || threshold > queue->max_items)
+    return RT_NOK;
+
+  rt_enter_critical();
+
+  queue->threshold = threshold;
+
+  // Lowered below what a blocked puller already waits on
+  if (threshold < queue->pull_wait)
+    queue->pull_wait = threshold;
+
+  if (LIST_LENGTH(&(queue->blocked_pull)) > 0 && queue->items >= queue->pull_wait) {
+    if (rt_queue_unblock(queue, (list_sorted_t *) &(queue->blocked_pull)) == RT_OK)
+      rt_pend_yield();
+  }
+
+  rt_exit_critical();
+
+  return RT_OK;
+}
@@ -0,0 +1,80 @@
+/*
+ * rt_resource.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_kernel.h"
+#include "rt_resource.h"
+
+rt_task_t volatile rt_resource_holder = NULL;
+
+void rt_resource_init(rt_resource_t *resource, uint32_t ceiling)
+{
+  if (ceiling >= RT_PRIO_LEVELS)
+    ceiling = RT_PRIO_LEVELS - 1;
+
+  resource->ceiling = ceiling;
+  resource->prev_prio = 0;
+  resource->prev_holder = NULL;
+}
+
+uint32_t rt_resource_get(rt_resource_t *resource)
+{
+  uint32_t ceiling = resource->ceiling;
+
+  if (rt_port_active_irq() || ceiling >= RT_PRIO_LEVELS)
+    return RT_NOK;
+
+  rt_enter_critical();
+
+  resource->prev_prio = current_task->priority;
+  resource->prev_holder = rt_resource_holder;
+  rt_resource_holder = current_task;
+
+  // Running, so nothing of higher prio is ready and it keeps running
+  if (ceiling > current_task->priority)
+    rt_list_task_prio(current_task, ceiling);
+
+#if RT_BASIC_ENABLE
+  resource->prev_level = rt_basic_ceiling_raise(ceiling);
+#endif
+
+  rt_exit_critical();
+
+  return RT_OK;
+}
+
+uint32_t rt_resource_release(rt_resource_t *resource)
+{
+  uint32_t prev_prio = resource->prev_prio;
+  uint32_t prio;
+
+  if (rt_port_active_irq())
+    return RT_NOK;
+
+  rt_enter_critical();
+
+  rt_resource_holder = resource->prev_holder;
+
+#if RT_BASIC_ENABLE
+  prev_prio = rt_basic_ceiling_restore(resource->prev_level, prev_prio);
+#endif
+
+  if (prev_prio < current_task->priority) {
+    rt_list_task_prio(current_task, prev_prio);
+
+    // Whatever got ready in the meantime above the restored prio runs now
+    for (prio = RT_PRIO_LEVELS-1; prio > prev_prio; prio--) {
+      if (LIST_LENGTH(&(ready[prio])) > 0) {
+        rt_pend_yield();
+        break;
+      }
+    }
+  }
+
+  rt_exit_critical();
+
+  return RT_OK;
+}
@@ -13,6 +13,10 @@ void rt_sem_init(rt_sem_t *sem, uint32_t count)
 {
   sem->counter = count;
   list_sorted_init((list_sorted_t *) &(sem->blocked));
+
+  RT_LATENCY_INIT(&(sem->latency));
+  RT_OBJ_REGISTER(&(sem->obj), RT_OBJ_SEM);
+  RT_WAITSET_LINK_INIT(&(sem->waitset));
 }
 
 uint32_t rt_sem_take_from_isr(rt_sem_t *sem)
@@ -23,6 +27,7 @@ uint32_t rt_sem_take_from_isr(rt_sem_t *sem)
 
   if (sem->counter > 0) {
     (sem->counter)--;
+    RT_OBJ_ACQUIRE(&(sem->obj), sem->counter);
   } else {
     sem_taken = RT_NOK;
   }
@@ -40,6 +45,8 @@ uint32_t rt_sem_give_from_isr(rt_sem_t *sem)
 
   (sem->counter)++;
 
+  RT_OBJ_DEPTH(&(sem->obj), sem->counter);
+
   if (LIST_LENGTH(&(sem->blocked)) > 0) {
     // Unblock the highest prio blocked task
     rt_task_t unblocked_task = (rt_task_t) LIST_MAX_VALUE_REF(&(sem->blocked));
@@ -47,8 +54,13 @@ uint32_t rt_sem_give_from_isr(rt_sem_t *sem)
     rt_list_task_undelayed(unblocked_task);
     rt_list_task_ready_next(unblocked_task);
 
+    RT_TRACE_UNBLOCK(unblocked_task, sem);
+    RT_LATENCY_GIVE(unblocked_task, &(sem->latency));
+
     if (unblocked_task->priority >= current_task->priority)
       task_unblocked = RT_OK;
+  } else {
+    task_unblocked = RT_WAITSET_SIGNAL(&(sem->waitset));
   }
 
   rt_exit_critical();
@@ -64,11 +76,14 @@ uint32_t rt_sem_take(rt_sem_t *sem, const uint32_t ticks_timeout)
 
   if (sem->counter == 0) {
     list_item_t *blocked_list_item = &(current_task->blocked_list_item);
+    uint32_t wait_start = RT_OBJ_WAIT_START();
 
     // Add currently running task to blocked list
     blocked_list_item->value = current_task->priority;
     list_sorted_insert((list_sorted_t *) &(sem->blocked), blocked_list_item);
 
+    RT_TRACE_BLOCK(current_task, sem);
+
     // Suspend task for ticks_timeout ticks
     rt_list_task_delayed(current_task, rt_get_tick()+ticks_timeout);
 
@@ -78,6 +93,8 @@ uint32_t rt_sem_take(rt_sem_t *sem, const uint32_t ticks_timeout)
 
     rt_enter_critical();
 
+    RT_LATENCY_WOKEN(current_task);
+
     list_sorted_remove(blocked_list_item);
 
     // Is it still fully taken?
@@ -85,10 +102,15 @@ uint32_t rt_sem_take(rt_sem_t *sem, const uint32_t ticks_timeout)
       sem_taken = RT_NOK;
     else
       (sem->counter)--;
+
+    RT_OBJ_WAITED(&(sem->obj), wait_start, sem_taken);
   } else {
     (sem->counter)--;
   }
 
+  if (sem_taken == RT_OK)
+    RT_OBJ_ACQUIRE(&(sem->obj), sem->counter);
+
   rt_exit_critical();
 
   return sem_taken;
@@ -0,0 +1,106 @@
+/*
+ * rt_shared.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_shared.h"
+
+void rt_shared_init(rt_shared_t *sh, void *data, uint32_t size)
+{
+  sh->data = data;
+  sh->size = size;
+  sh->seq = 0;
+}
+
+void *rt_shared_write_begin(rt_shared_t *sh)
+{
+  // Readers that preempted an earlier write retry
+  rt_enter_critical();
+
+  sh->seq++;
+  rt_port_barrier();
+
+  return sh->data;
+}
+
+void rt_shared_write_end(rt_shared_t *sh)
+{
+  rt_port_barrier();
+  sh->seq++;
+
+  rt_exit_critical();
+}
+
+void rt_shared_write(rt_shared_t *sh, const void * const value)
+{
+  rt_queue_copy((uint8_t *) rt_shared_write_begin(sh), (const uint8_t *) value, sh->size);
+  rt_shared_write_end(sh);
+}
+
+uint32_t rt_shared_read(const rt_shared_t *sh, void * const value)
+{
+  // Returns the number of writes the value is from
+  uint32_t seq;
+
+  do {
+    seq = rt_shared_read_begin(sh);
+    rt_queue_copy((uint8_t *) value, (const uint8_t *) sh->data, sh->size);
+  } while (rt_shared_read_retry(sh, seq));
+
+  return seq >> 1;
+}
+
+void rt_shared_dbuf_init(rt_shared_dbuf_t *db, uint8_t *buffer, uint32_t size)
+{
+  db->buffer = buffer;
+  db->size = size;
+  db->seq = 0;
+  db->started = 0;
+}
+
+static uint8_t *rt_shared_dbuf_spare(rt_shared_dbuf_t *db)
+{
+  // The copy that is not current. Readers that still read it retry.
+  db->started = db->seq + 1;
+  rt_port_barrier();
+
+  return db->buffer + (db->started & 1) * db->size;
+}
+
+void *rt_shared_dbuf_write_begin(rt_shared_dbuf_t *db)
+{
+  // Starts from the current value, so the writer can change parts of it
+  uint8_t *spare = rt_shared_dbuf_spare(db);
+
+  rt_queue_copy(spare, db->buffer + (db->seq & 1) * db->size, db->size);
+
+  return spare;
+}
+
+void rt_shared_dbuf_publish(rt_shared_dbuf_t *db)
+{
+  rt_port_barrier();
+  db->seq = db->started;
+}
+
+void rt_shared_dbuf_write(rt_shared_dbuf_t *db, const void * const value)
+{
+  rt_queue_copy(rt_shared_dbuf_spare(db), (const uint8_t *) value, db->size);
+  rt_shared_dbuf_publish(db);
+}
+
+uint32_t rt_shared_dbuf_read(const rt_shared_dbuf_t *db, void * const value)
+{
+  // Returns the number of writes the value is from
+  const void *current;
+  uint32_t seq;
+
+  do {
+    current = rt_shared_dbuf_read_begin(db, &seq);
+    rt_queue_copy((uint8_t *) value, (const uint8_t *) current, db->size);
+  } while (rt_shared_dbuf_read_retry(db, seq));
+
+  return seq;
+}
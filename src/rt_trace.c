@@ -0,0 +1,128 @@
+/*
+ * rt_trace.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_kernel.h"
+#include "rt_trace.h"
+
+#if RT_TRACE_ENABLE
+
+#define RT_TRACE_INDEX_MASK (RT_TRACE_BUFFER_RECORDS-1)
+
+rt_trace_t rt_trace;
+
+#if RT_TRACE_ITM_ENABLE
+static uint32_t itm_word = 0;   // Next word to send of the record at tail
+static uint32_t itm_lost = 0;   // Lost count as last sent
+#endif
+
+static uint32_t rt_trace_skip_lost(void)
+{
+  // The oldest records have been overwritten if the reader fell behind
+  if (rt_trace.head - rt_trace.tail > RT_TRACE_BUFFER_RECORDS) {
+    rt_trace.lost += rt_trace.head - rt_trace.tail - RT_TRACE_BUFFER_RECORDS;
+    rt_trace.tail = rt_trace.head - RT_TRACE_BUFFER_RECORDS;
+    return 1;
+  }
+
+  return 0;
+}
+
+void rt_trace_init(void)
+{
+  rt_trace.magic = RT_TRACE_MAGIC;
+  rt_trace.version = RT_TRACE_VERSION;
+  rt_trace.record_size = sizeof(rt_trace_record_t);
+  rt_trace.max_records = RT_TRACE_BUFFER_RECORDS;
+  rt_trace.cpu_hz = RT_PORT_CYCLES_HZ;
+  rt_trace.head = 0;
+  rt_trace.tail = 0;
+  rt_trace.lost = 0;
+}
+
+void rt_trace_record(const uint8_t event, rt_tcb_t * const task, const void * const object, const uint16_t data)
+{
+  rt_trace_record_t *record;
+
+  // May be called from any context, including ISRs above RT_MASK_IRQ_PRIO,
+  // so all interrupts are masked instead of using rt_enter_critical.
+  uint32_t primask = rt_port_irq_save();
+
+  record = &(rt_trace.record[rt_trace.head & RT_TRACE_INDEX_MASK]);
+  rt_trace.head++;
+
+  record->timestamp = rt_get_cycles();
+  record->task = (uint32_t) (uintptr_t) task;
+  record->object = (uint32_t) (uintptr_t) object;
+  record->event = event;
+  record->prio = (task != NULL) ? (uint8_t) task->priority : 0;
+  record->data = data;
+
+  rt_port_irq_restore(primask);
+
+  RT_TRACE_FLUSH();
+}
+
+uint32_t rt_trace_read(rt_trace_record_t *records, const uint32_t max_records)
+{
+  uint32_t cnt, primask;
+
+  // One record per critical section to keep the interrupt latency down
+  for (cnt = 0; cnt < max_records; cnt++) {
+    primask = rt_port_irq_save();
+
+    rt_trace_skip_lost();
+
+    if (rt_trace.tail == rt_trace.head) {
+      rt_port_irq_restore(primask);
+      break;
+    }
+
+    records[cnt] = rt_trace.record[rt_trace.tail & RT_TRACE_INDEX_MASK];
+    rt_trace.tail++;
+
+    rt_port_irq_restore(primask);
+  }
+
+  return cnt;
+}
+
+#if RT_TRACE_ITM_ENABLE
+void rt_trace_itm_flush(void)
+{
+  const uint32_t *words;
+  uint32_t port;
+  uint32_t primask = rt_port_irq_save();
+
+  // A partly sent record that was overwritten is dropped by the decoder
+  if (rt_trace_skip_lost())
+    itm_word = 0;
+
+  if (itm_word == 0 && itm_lost != rt_trace.lost && rt_port_itm_ready(RT_TRACE_ITM_PORT+2)) {
+    rt_port_itm_write(RT_TRACE_ITM_PORT+2, rt_trace.lost);
+    itm_lost = rt_trace.lost;
+  }
+
+  while (rt_trace.tail != rt_trace.head) {
+    port = (itm_word == 0) ? RT_TRACE_ITM_PORT : RT_TRACE_ITM_PORT+1;
+
+    if (!rt_port_itm_ready(port))
+      break;
+
+    words = (const uint32_t *) &(rt_trace.record[rt_trace.tail & RT_TRACE_INDEX_MASK]);
+    rt_port_itm_write(port, words[itm_word]);
+
+    if (++itm_word == sizeof(rt_trace_record_t)/4) {
+      itm_word = 0;
+      rt_trace.tail++;
+    }
+  }
+
+  rt_port_irq_restore(primask);
+}
+#endif
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ * rt_waitset.c
+ *
+ *  Created on: 19 oct 2026
+ *      Author: osannolik
+ */
+
+#include "rt_kernel.h"
+#include "rt_sem.h"
+#include "rt_queue.h"
+#include "rt_waitset.h"
+
+#if RT_WAITSET_ENABLE
+
+enum {
+  RT_WAITSET_NONE = 0,
+  RT_WAITSET_SEM,
+  RT_WAITSET_QUEUE,
+  RT_WAITSET_NOTIFY
+};
+
+static uint32_t rt_waitset_add(rt_waitset_t *ws, void *member, const uint32_t type, const uint32_t id);
+static uint32_t rt_waitset_ready(rt_waitset_t *ws, uint32_t * const id);
+
+void rt_waitset_init(rt_waitset_t *ws)
+{
+  uint32_t id;
+
+  ws->flagged = 0;
+  ws->notified = 0;
+  ws->waiting = NULL;
+
+  for (id = 0; id < RT_WAITSET_MEMBERS; id++) {
+    ws->member[id] = NULL;
+    ws->type[id] = RT_WAITSET_NONE;
+  }
+}
+
+uint32_t rt_waitset_add_sem(rt_waitset_t *ws, struct rt_sem *sem, const uint32_t id)
+{
+  if (rt_waitset_add(ws, sem, RT_WAITSET_SEM, id) != RT_OK)
+    return RT_NOK;
+
+  sem->waitset.set = ws;
+  sem->waitset.id = id;
+
+  return RT_OK;
+}
+
+uint32_t rt_waitset_add_queue(rt_waitset_t *ws, struct rt_queue *queue, const uint32_t id)
+{
+  if (rt_waitset_add(ws, queue, RT_WAITSET_QUEUE, id) != RT_OK)
+    return RT_NOK;
+
+  queue->waitset.set = ws;
+  queue->waitset.id = id;
+
+  return RT_OK;
+}
+
+uint32_t rt_waitset_add_notify(rt_waitset_t *ws, const uint32_t id)
+{
+  return rt_waitset_add(ws, NULL, RT_WAITSET_NOTIFY, id);
+}
+
+uint32_t rt_waitset_notify_from_isr(rt_waitset_t *ws, const uint32_t id)
+{
+  uint32_t task_unblocked = RT_NOK;
+
+  if (id >= RT_WAITSET_MEMBERS || ws->type[id] != RT_WAITSET_NOTIFY)
+    return RT_NOK;
+
+  rt_enter_critical();
+
+  ws->notified |= (1u << id);
+  task_unblocked = rt_waitset_signal(ws, id);
+
+  rt_exit_critical();
+
+  return task_unblocked;
+}
+
+uint32_t rt_waitset_notify(rt_waitset_t *ws, const uint32_t id)
+{
+  rt_enter_critical();
+
+  if (rt_waitset_notify_from_isr(ws, id) != RT_NOK)
+    rt_pend_yield();
+
+  rt_exit_critical();
+
+  return RT_OK;
+}
+
+uint32_t rt_waitset_wait(rt_waitset_t *ws, uint32_t * const id, const uint32_t ticks_timeout)
+{
+  uint32_t member_ready;
+  uint32_t wake_up_tick = rt_get_tick() + ticks_timeout;
+
+  rt_enter_critical();
+
+  while ((member_ready = rt_waitset_ready(ws, id)) != RT_OK) {
+    if (rt_port_active_irq() || (int32_t) (wake_up_tick - rt_get_tick()) <= 0)
+      break;
+
+    ws->waiting = current_task;
+
+    RT_TRACE_BLOCK(current_task, ws);
+
+    // Suspend task until a member is signalled or the time is up
+    rt_list_task_delayed(current_task, wake_up_tick);
+
+    rt_exit_critical();
+
+    // yields here
+
+    rt_enter_critical();
+
+    ws->waiting = NULL;
+  }
+
+  rt_exit_critical();
+
+  return member_ready;
+}
+
+uint32_t rt_waitset_signal(rt_waitset_t *ws, const uint32_t id)
+{
+  // From a give or push, in a critical section. RT_OK if a task of higher
+  // prio was unblocked.
+  rt_task_t waiting = ws->waiting;
+
+  ws->flagged |= (1u << id);
+
+  if (waiting == NULL)
+    return RT_NOK;
+
+  ws->waiting = NULL;
+
+  rt_list_task_undelayed(waiting);
+  rt_list_task_ready_next(waiting);
+
+  RT_TRACE_UNBLOCK(waiting, ws);
+
+  if (waiting->priority >= current_task->priority)
+    return RT_OK;
+  else
+    return RT_NOK;
+}
+
+static uint32_t rt_waitset_add(rt_waitset_t *ws, void *member, const uint32_t type, const uint32_t id)
+{
+  if (id >= RT_WAITSET_MEMBERS || ws->type[id] != RT_WAITSET_NONE)
+    return RT_NOK;
+
+  rt_enter_critical();
+
+  ws->member[id] = member;
+  ws->type[id] = type;
+
+  // Could be ready already
+  ws->flagged |= (1u << id);
+
+  rt_exit_critical();
+
+  return RT_OK;
+}
+
+static uint32_t rt_waitset_ready(rt_waitset_t *ws, uint32_t * const id)
+{
+  // The flagged member of lowest id that is ready, in a critical section.
+  // The ones found not to be are unflagged until signalled again.
+  uint32_t flagged = ws->flagged;
+  uint32_t i, ready;
+
+  while (flagged != 0) {
+    i = __builtin_ctz(flagged);
+    flagged &= flagged - 1;
+
+    switch (ws->type[i]) {
+    case RT_WAITSET_SEM:
+      ready = (((rt_sem_t *) ws->member[i])->counter > 0);
+      break;
+    case RT_WAITSET_QUEUE:
+      ready = (((rt_queue_t *) ws->member[i])->items >= ((rt_queue_t *) ws->member[i])->threshold);
+      break;
+    case RT_WAITSET_NOTIFY:
+      ready = ((ws->notified & (1u << i)) != 0);
+      ws->notified &= ~(1u << i);
+      break;
+    default:
+      ready = 0;
+      break;
+    }
+
+    if (ready) {
+      // Taking it is up to the caller, so it stays flagged
+      if (ws->type[i] == RT_WAITSET_NOTIFY)
+        ws->flagged &= ~(1u << i);
+
+      *id = i;
+      return RT_OK;
+    }
+
+    ws->flagged &= ~(1u << i);
+  }
+
+  return RT_NOK;
+}
+
+#endif
@@ -149,6 +149,10 @@ volatile uint32_t psr;// Program status register.
   */
 void MemManage_Handler(void)
 {
+#if RT_MPU_STACK_GUARD_ENABLE
+  rt_stack_guard_fault();
+#endif
+
   /* Go to infinite loop when Memory Manage exception occurs */
   while (1)
   {
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""
+Generates the static image of the tasks declared with DEFINE_STATIC_TASK
+(see inc/rt_kernel.h), for RT_STATIC_IMAGE_ENABLE, e.g.
+
+    rt_image.py src/*.c inc/*.h -o build/rt_image.c
+
+The generated file defines the stacks with the initial frame already
+built (RT_PORT_STACK_IMAGE), the tcbs and the ready lists with the tasks
+linked in, all as initialized data. The startup code copying .data is
+then all there is to creating them, and rt_init and rt_start take the
+same time no matter how many tasks there are.
+
+Stack sizes and prios are evaluated here, so keep them plain numbers or
+simple defines, as for rt_rta.py.
+
+Author: osannolik
+"""
+
+import argparse
+import re
+import sys
+
+from rt_rta import c_eval, split_args
+
+TASK = re.compile(r'^\s*DEFINE_STATIC_TASK\s*\(([^;]*)\)\s*;', re.M)
+DEFINE = re.compile(r'^\s*#\s*define\s+(\w+)\s+(.+?)\s*(//.*)?$', re.M)
+FIELDS = ['fcn', 'handle', 'name', 'prio', 'stack_size', 'params']
+
+
+def parse(files):
+    text = ''
+    for path in files:
+        with open(path, errors='replace') as f:
+            text += f.read() + '\n'
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+
+    defines = {}
+    for m in DEFINE.finditer(text):
+        if '(' not in m.group(1):
+            defines[m.group(1)] = m.group(2)
+
+    tasks = []
+    for m in TASK.finditer(text):
+        args = split_args(m.group(1).replace('\\\n', ' '))
+        if len(args) != len(FIELDS):
+            raise ValueError('DEFINE_STATIC_TASK(%s) needs %d arguments' % (m.group(1), len(FIELDS)))
+        task = dict(zip(FIELDS, args))
+        task['prio'] = c_eval(task['prio'], defines)
+        task['stack_size'] = c_eval(task['stack_size'], defines)
+        tasks.append(task)
+
+    if 'RT_PRIO_LEVELS' not in defines:
+        raise ValueError('RT_PRIO_LEVELS not found, include inc/rt_kernel_defs.h')
+    return tasks, c_eval(defines['RT_PRIO_LEVELS'], defines)
+
+
+def item(prio, task, prev, next):
+    return '{%d, &%s, (void *) &ready[%d], %s, %s}' % (prio, task, prio, prev, next)
+
+
+def generate(tasks, prio_levels):
+    handles = set()
+    for task in tasks:
+        if task['handle'] in handles:
+            raise ValueError('task %s is declared twice' % task['handle'])
+        if not 0 <= task['prio'] < prio_levels:
+            raise ValueError('task %s: prio %d, RT_PRIO_LEVELS is %d' % (task['handle'], task['prio'], prio_levels))
+        if task['stack_size'] < 32:
+            raise ValueError('task %s: stack of %d words is too small' % (task['handle'], task['stack_size']))
+        handles.add(task['handle'])
+
+    by_prio = [[t for t in tasks if t['prio'] == prio] for prio in range(prio_levels)]
+
+    out = ['// Generated by tools/rt_image.py, do not edit',
+           '',
+           '#include "rt_kernel.h"',
+           '',
+           '#if RT_STATIC_IMAGE_ENABLE',
+           '',
+           '_Static_assert(RT_PRIO_LEVELS == %d, "rt_image.c is out of date");' % prio_levels,
+           '']
+
+    for task in tasks:
+        out.append('void %s(void *p);' % task['fcn'])
+    for task in tasks:
+        out.append('extern rt_tcb_t %s;' % task['handle'])
+    out.append('')
+
+    # The ready lists, each with its tasks in declaration order and the
+    # iterator at the first one, as after rt_create_task of each
+    out.append('volatile list_sorted_t ready[RT_PRIO_LEVELS] = {')
+    for prio, prio_tasks in enumerate(by_prio):
+        end = '(list_item_t *) &ready[%d].end' % prio
+        if prio_tasks:
+            first = '&%s.list_item' % prio_tasks[0]['handle']
+            last = '&%s.list_item' % prio_tasks[-1]['handle']
+            out.append('  {%d, {LIST_END_VALUE, NULL, (void *) &ready[%d], %s, %s}, %s},'
+                       % (len(prio_tasks), prio, last, first, first))
+        else:
+            out.append('  {0, {LIST_END_VALUE, NULL, (void *) &ready[%d], %s, %s}, NULL},' % (prio, end, end))
+    out.append('};')
+    out.append('')
+
+    for task in tasks:
+        h, size = task['handle'], task['stack_size']
+        out.append('uint32_t %s_stack[%d] __attribute__((aligned(RT_STACK_ALIGNMENT))) = RT_PORT_STACK_IMAGE(%d, %s, %s);'
+                   % (h, size, size, task['fcn'], task['params']))
+    out.append('')
+
+    # rt_task_list is last created first
+    previous = 'NULL'
+    for task in tasks:
+        h, prio, size = task['handle'], task['prio'], task['stack_size']
+        prio_tasks = by_prio[prio]
+        i = prio_tasks.index(task)
+        end = '(list_item_t *) &ready[%d].end' % prio
+        prev = '&%s.list_item' % prio_tasks[i - 1]['handle'] if i > 0 else end
+        next = '&%s.list_item' % prio_tasks[i + 1]['handle'] if i + 1 < len(prio_tasks) else end
+
+        out += ['rt_tcb_t %s = {' % h,
+                '  .sp = &%s_stack[RT_PORT_STACK_IMAGE_SP(%d)],' % (h, size),
+                '  .code_start = (void *) %s,' % task['fcn'],
+                '  .task_name = %s,' % task['name'],
+                '  .priority = %d,' % prio,
+                '  .base_prio = %d,' % prio,
+                '  .stack_size = %d,' % size,
+                '  .stack_start = %s_stack,' % h,
+                '  .list_item = %s,' % item(prio, h, prev, next),
+                '  .blocked_list_item = {0, &%s, NULL, NULL, NULL},' % h,
+                '  .next_task = %s,' % previous,
+                '};',
+                '']
+        previous = '&' + h
+
+    out += ['rt_task_t const rt_image_task_list = %s;' % previous,
+            '',
+            '#endif',
+            '']
+    return '\n'.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('files', nargs='+', help='sources and headers with the task definitions and defines')
+    parser.add_argument('-o', '--output', help='generated file (default: stdout)')
+    args = parser.parse_args()
+
+    try:
+        tasks, prio_levels = parse(args.files)
+        image = generate(tasks, prio_levels)
+    except ValueError as e:
+        print('rt_image: %s' % e, file=sys.stderr)
+        return 1
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(image)
+    else:
+        sys.stdout.write(image)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
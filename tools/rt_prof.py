@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""
+Symbolize a dump of the PC-sampling profiler histogram (see inc/rt_prof.h)
+against the elf file, e.g. after
+
+    dump binary value prof.bin rt_prof
+
+in gdb. Prints a flat profile per task/ISR, or with --folded, folded stacks
+("context;function count") that flamegraph.pl or speedscope can render.
+
+Author: osannolik
+"""
+
+import argparse
+import bisect
+import struct
+import subprocess
+import sys
+
+MAGIC = 0x52545046
+HEADER = struct.Struct('<6I')
+SLOT = struct.Struct('<3I')
+
+EXCEPTION_NAMES = {
+    2: 'NMI', 3: 'HardFault', 4: 'MemManage', 5: 'BusFault', 6: 'UsageFault',
+    11: 'SVCall', 12: 'DebugMon', 14: 'PendSV', 15: 'SysTick',
+}
+
+
+class Symbols:
+    def __init__(self, elf, nm):
+        out = subprocess.run([nm, '-n', '--defined-only', elf], check=True,
+                             capture_output=True, text=True).stdout
+        self.functions = []
+        self.data = {}
+        for line in out.splitlines():
+            fields = line.split()
+            if len(fields) != 3:
+                continue
+            addr, kind, name = int(fields[0], 16), fields[1], fields[2]
+            if kind in 'tTwW':
+                self.functions.append((addr & ~1, name))
+            elif kind in 'bBdD':
+                self.data[addr] = name
+        self.functions.sort()
+        self.addrs = [a for a, _ in self.functions]
+
+    def function(self, pc):
+        i = bisect.bisect_right(self.addrs, pc & ~1) - 1
+        return self.functions[i][1] if i >= 0 else '0x%08x' % pc
+
+    def context(self, context):
+        if context < 0x200:
+            return 'ISR ' + EXCEPTION_NAMES.get(context, 'IRQ%d' % (context - 16))
+        return self.data.get(context, 'task@0x%08x' % context)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help='dump of rt_prof')
+    parser.add_argument('elf', help='elf file, e.g. build/rtos-cm4.elf')
+    parser.add_argument('--nm', default='arm-none-eabi-nm', help='nm executable')
+    parser.add_argument('--folded', action='store_true', help='print folded stacks for flame graphs')
+    parser.add_argument('--top', type=int, default=20, help='functions listed per context (default: 20)')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    magic, version, slots, sample_hz, samples, dropped = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        sys.exit('Bad profiler magic 0x%08x' % magic)
+
+    symbols = Symbols(args.elf, args.nm)
+
+    profile = {}
+    for i in range(slots):
+        pc, context, count = SLOT.unpack_from(data, HEADER.size + i * SLOT.size)
+        if count == 0:
+            continue
+        functions = profile.setdefault(symbols.context(context), {})
+        function = symbols.function(pc)
+        functions[function] = functions.get(function, 0) + count
+
+    if args.folded:
+        for context, functions in sorted(profile.items()):
+            for function, count in sorted(functions.items()):
+                print('%s;%s %d' % (context.replace(' ', '_'), function, count))
+        return
+
+    print('%d samples at %d Hz (%.2f s), %d dropped' % (samples, sample_hz, samples / float(sample_hz or 1), dropped))
+    total = float(max(samples - dropped, 1))
+    for context, functions in sorted(profile.items(), key=lambda kv: -sum(kv[1].values())):
+        context_samples = sum(functions.values())
+        print('\n%s: %d samples (%.1f%%)' % (context, context_samples, 100 * context_samples / total))
+        ranked = sorted(functions.items(), key=lambda kv: -kv[1])
+        for function, count in ranked[:args.top]:
+            print('  %6.1f%% %8d  %s' % (100 * count / total, count, function))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+Fixed priority response time analysis of the tasks declared with
+DEFINE_PERIODIC_TASK (see inc/rt_kernel.h), e.g.
+
+    rt_rta.py src/*.c inc/*.h --tick-us 2 --switch-us 1
+
+For each task the worst case response time is found by iterating
+
+    R = C + B + sum(ceil(R / Tj) * Cj) + ceil(R / Ttick) * Ctick
+
+over all tasks j of higher or equal prio (equal prio tasks share the cpu
+by time slicing) and the ISRs given with --isr. C includes two context
+switches per job. B is the largest blocking_us of the lower prio tasks,
+or the kernel's own critical sections if that is larger.
+
+Exits with 1 if any task may miss its deadline, or has no period, so
+that it can stop a build.
+
+Author: osannolik
+"""
+
+import argparse
+import json
+import math
+import re
+import sys
+
+DEFINE = re.compile(r'^\s*#\s*define\s+(\w+)\s+(.+?)\s*(//.*)?$', re.M)
+TASK = re.compile(r'^\s*DEFINE_PERIODIC_TASK\s*\(([^;]*)\)\s*;', re.M)
+FIELDS = ['fcn', 'handle', 'name', 'prio', 'stack_size', 'period', 'deadline', 'wcet_us', 'blocking_us']
+
+
+def c_eval(expr, defines, depth=0):
+    # Enough for numbers and simple defines, like (0x0F) or (2*TICKS)
+    if depth > 16:
+        raise ValueError('recursive define in ' + expr)
+    expr = re.sub(r'\b(0[xX][0-9a-fA-F]+|\d+)[uUlL]+\b', r'\1', expr)
+    expr = re.sub(r'\b[A-Za-z_]\w*\b', lambda m: '(%s)' % c_eval(defines[m.group(0)], defines, depth + 1)
+                  if m.group(0) in defines else m.group(0), expr)
+    expr = expr.replace('/', '//')
+    return int(eval(expr, {'__builtins__': {}}))
+
+
+def split_args(args):
+    parts, depth, current = [], 0, ''
+    for c in args:
+        if c == ',' and depth == 0:
+            parts.append(current.strip())
+            current = ''
+            continue
+        depth += (c == '(') - (c == ')')
+        current += c
+    parts.append(current.strip())
+    return parts
+
+
+def parse(files):
+    text = ''
+    for path in files:
+        with open(path, errors='replace') as f:
+            text += f.read() + '\n'
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+
+    defines = {}
+    for m in DEFINE.finditer(text):
+        if '(' not in m.group(1):
+            defines[m.group(1)] = m.group(2)
+
+    tasks = []
+    for m in TASK.finditer(text):
+        args = split_args(m.group(1).replace('\\\n', ' '))
+        if len(args) != len(FIELDS):
+            continue
+        task = dict(zip(FIELDS, args))
+        task['name'] = task['name'].strip('"')
+        for field in FIELDS[3:]:
+            task[field] = c_eval(task[field], defines)
+        tasks.append(task)
+    return tasks
+
+
+def response_times(tasks, isrs, args):
+    # Everything in ns to stay with integers
+    tick_ns = 10**9 // args.tick_hz
+    kernel_ns = int(args.kernel_us * 1000)
+    tick_cost_ns = int(args.tick_us * 1000)
+
+    for task in tasks:
+        task['T'] = task['period'] * tick_ns
+        task['D'] = task['deadline'] * tick_ns
+        task['C'] = int((task['wcet_us'] + 2 * args.switch_us) * 1000)
+
+    for task in tasks:
+        others = [t for t in tasks if t is not task and t['prio'] >= task['prio']]
+        interference = [(t['T'], t['C']) for t in others] + isrs + [(tick_ns, tick_cost_ns)]
+        lower = [t['blocking_us'] * 1000 for t in tasks if t['prio'] < task['prio']]
+        task['B'] = max(lower + [kernel_ns])
+
+        r = task['C'] + task['B']
+        while True:
+            r_next = task['C'] + task['B'] + sum(math.ceil(r / T) * C for T, C in interference)
+            if r_next == r or r_next > task['D']:
+                break
+            r = r_next
+        task['R'] = r_next
+        task['ok'] = r_next <= task['D']
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('files', nargs='+', help='sources and headers with the task definitions and defines')
+    parser.add_argument('--tick-hz', type=int, default=1000, help='kernel tick rate (default: 1000)')
+    parser.add_argument('--tick-us', type=float, default=0.0, help='cost of one SysTick, in us')
+    parser.add_argument('--switch-us', type=float, default=0.0, help='cost of one context switch, in us')
+    parser.add_argument('--kernel-us', type=float, default=0.0, help='longest kernel critical section, in us')
+    parser.add_argument('--isr', action='append', default=[], metavar='NAME:PERIOD_US:WCET_US',
+                        help='interrupt load on all tasks, may be repeated')
+    parser.add_argument('--json', action='store_true', help='print the result as json')
+    args = parser.parse_args()
+
+    tasks = parse(args.files)
+    if not tasks:
+        return 0
+
+    for t in tasks:
+        if t['period'] <= 0:
+            print('rt_rta: %s: period must be at least one tick' % t['name'], file=sys.stderr)
+            return 1
+
+    isrs = []
+    for isr in args.isr:
+        name, period_us, wcet_us = isr.split(':')
+        isrs.append((int(float(period_us) * 1000), int(float(wcet_us) * 1000)))
+
+    response_times(tasks, isrs, args)
+    tasks.sort(key=lambda t: -t['prio'])
+
+    if args.json:
+        print(json.dumps([{'name': t['name'], 'prio': t['prio'], 'period_us': t['T'] / 1e3,
+                           'deadline_us': t['D'] / 1e3, 'cost_us': t['C'] / 1e3, 'block_us': t['B'] / 1e3,
+                           'wcrt_us': t['R'] / 1e3, 'ok': t['ok']} for t in tasks], indent=2))
+    else:
+        print('%-12s %4s %10s %10s %10s %10s %10s %10s' % ('task', 'prio', 'period_us', 'deadline_us',
+                                                          'cost_us', 'block_us', 'wcrt_us', 'slack_us'))
+        for t in tasks:
+            print('%-12s %4d %10.1f %10.1f %10.1f %10.1f %10s %10s%s' % (
+                t['name'], t['prio'], t['T'] / 1e3, t['D'] / 1e3, t['C'] / 1e3, t['B'] / 1e3,
+                '%.1f' % (t['R'] / 1e3) if t['ok'] else '>%.1f' % (t['D'] / 1e3),
+                '%.1f' % ((t['D'] - t['R']) / 1e3) if t['ok'] else '-',
+                '' if t['ok'] else '  DEADLINE MISS'))
+
+    return 0 if all(t['ok'] for t in tasks) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+"""
+Convert a kernel trace (see inc/rt_trace.h) to Chrome trace JSON, which can be
+opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+
+The input is either a dump of the rt_trace struct, e.g. from gdb:
+
+    dump binary value trace.bin rt_trace
+
+or, with --raw, a plain stream of records as delivered by rt_trace_read()
+over a UART.
+
+With --swo the input is a raw SWO capture of the ITM stream sent with
+RT_TRACE_ITM_ENABLE, e.g. from OpenOCD:
+
+    tpiu config internal swo.bin uart off 168000000 2000000
+
+Author: osannolik
+"""
+
+import argparse
+import json
+import struct
+import subprocess
+import sys
+
+MAGIC = 0x52545452
+HEADER = struct.Struct('<8I')
+RECORD = struct.Struct('<IIIBBH')
+
+EVT_TASK_CREATE = 1
+EVT_SWITCH_IN = 2
+EVT_SWITCH_OUT = 3
+EVT_BLOCK = 4
+EVT_UNBLOCK = 5
+EVT_DELAY = 6
+EVT_WAKE = 7
+EVT_ISR_ENTER = 8
+EVT_ISR_EXIT = 9
+
+EXCEPTION_NAMES = {
+    2: 'NMI', 3: 'HardFault', 4: 'MemManage', 5: 'BusFault', 6: 'UsageFault',
+    11: 'SVCall', 12: 'DebugMon', 14: 'PendSV', 15: 'SysTick',
+}
+
+
+def read_symbols(elf, nm):
+    """Map data addresses to symbol names, used to name tasks and objects."""
+    symbols = {}
+    if elf is None:
+        return symbols
+    out = subprocess.run([nm, elf], check=True, capture_output=True, text=True).stdout
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[1] in 'bBdDrR':
+            symbols[int(fields[0], 16)] = fields[2]
+    return symbols
+
+
+def parse_swo(data, itm_port):
+    """Returns (lost, records) from ITM packets, see inc/rt_trace.h."""
+    lost = 0
+    broken = 0
+    overflows = 0
+    records = []
+    words = None
+    i = 0
+
+    while i < len(data):
+        header = data[i]
+        i += 1
+        if header == 0x00:
+            # Synchronization, at least five zeros and then 0x80
+            while i < len(data) and data[i] == 0x00:
+                i += 1
+            i += 1
+        elif header == 0x70:
+            overflows += 1
+        elif header & 0x03 == 0:
+            # Timestamp or extension packet, skip the continuation bytes
+            if header & 0x80:
+                while i < len(data) and data[i] & 0x80:
+                    i += 1
+                i += 1
+        else:
+            size = {1: 1, 2: 2, 3: 4}[header & 0x03]
+            payload = data[i:i + size]
+            i += size
+            if header & 0x04 or len(payload) != 4:
+                continue  # Hardware source (DWT), or not from the kernel
+            port = header >> 3
+            value = struct.unpack('<I', payload)[0]
+            if port == itm_port:
+                if words is not None:
+                    broken += 1
+                words = [value]
+            elif port == itm_port + 1 and words is not None:
+                words.append(value)
+                if len(words) == RECORD.size // 4:
+                    records.append(RECORD.unpack(struct.pack('<4I', *words)))
+                    words = None
+            elif port == itm_port + 2:
+                lost = value
+
+    if overflows or broken:
+        print('Note: %d ITM overflows, %d incomplete records dropped' % (overflows, broken), file=sys.stderr)
+
+    return lost + broken, records
+
+
+def parse(data, raw, cpu_hz):
+    """Returns (cpu_hz, lost, records) with records in chronological order."""
+    lost = 0
+    if not raw:
+        if len(data) < HEADER.size:
+            sys.exit('Trace dump is too short')
+        magic, version, record_size, max_records, hz, head, tail, lost = HEADER.unpack_from(data)
+        if magic != MAGIC:
+            sys.exit('Bad trace magic 0x%08x, use --raw for streamed records' % magic)
+        if record_size != RECORD.size:
+            sys.exit('Unsupported record size %d' % record_size)
+        cpu_hz = cpu_hz or hz
+        body = data[HEADER.size:HEADER.size + max_records * record_size]
+        slots = [RECORD.unpack_from(body, i * record_size) for i in range(max_records)]
+        # The ring always holds the latest max_records records, oldest at head
+        if head > max_records:
+            lost += head - max_records
+            start = head % max_records
+            records = slots[start:] + slots[:start]
+        else:
+            records = slots[:head]
+    else:
+        n = len(data) // RECORD.size
+        records = [RECORD.unpack_from(data, i * RECORD.size) for i in range(n)]
+
+    return cpu_hz, lost, records
+
+
+class Exporter:
+    def __init__(self, cpu_hz, symbols):
+        self.cpu_hz = cpu_hz
+        self.symbols = symbols
+        self.events = []
+        self.tids = {}
+        self.running = {}
+        self.isr_stack = []
+        self.flows = {}
+        self.flow_id = 0
+        self.last_cycles = None
+        self.cycles = 0
+
+    def name(self, addr, kind):
+        return self.symbols.get(addr, '%s@0x%08x' % (kind, addr))
+
+    def tid(self, key, name):
+        if key not in self.tids:
+            self.tids[key] = len(self.tids) + 1
+            self.events.append({'ph': 'M', 'name': 'thread_name', 'pid': 1,
+                                'tid': self.tids[key], 'args': {'name': name}})
+        return self.tids[key]
+
+    def task_tid(self, task):
+        return self.tid(('task', task), self.name(task, 'task'))
+
+    def us(self):
+        return self.cycles * 1e6 / self.cpu_hz
+
+    def add(self, ph, name, tid, **kw):
+        ev = {'ph': ph, 'name': name, 'pid': 1, 'tid': tid, 'ts': self.us()}
+        ev.update(kw)
+        self.events.append(ev)
+
+    def record(self, timestamp, task, obj, event, prio, data):
+        # The cycle counter is 32 bits, unwrap it
+        if self.last_cycles is not None:
+            self.cycles += (timestamp - self.last_cycles) & 0xFFFFFFFF
+        self.last_cycles = timestamp
+
+        if event == EVT_TASK_CREATE:
+            self.add('i', 'create', self.task_tid(task), s='t', args={'prio': data})
+        elif event == EVT_SWITCH_IN:
+            tid = self.task_tid(task)
+            self.running[task] = self.us()
+            self.add('B', 'running', tid, args={'prio': prio})
+            if task in self.flows:
+                self.add('f', 'wakeup', tid, id=self.flows.pop(task), bp='e', cat='wakeup')
+        elif event == EVT_SWITCH_OUT:
+            if self.running.pop(task, None) is not None:
+                self.add('E', 'running', self.task_tid(task))
+        elif event == EVT_BLOCK:
+            self.add('i', 'block', self.task_tid(task), s='t',
+                     args={'object': self.name(obj, 'object'), 'prio': prio})
+        elif event == EVT_UNBLOCK:
+            self.add('i', 'unblock', self.task_tid(task), s='t',
+                     args={'object': self.name(obj, 'object'), 'prio': prio})
+            self.flow_id += 1
+            self.flows[task] = self.flow_id
+            self.add('s', 'wakeup', self.task_tid(task), id=self.flow_id, cat='wakeup')
+        elif event == EVT_DELAY:
+            self.add('i', 'delay', self.task_tid(task), s='t', args={'wake_up_tick_lsb': data})
+        elif event == EVT_WAKE:
+            self.add('i', 'wake', self.task_tid(task), s='t')
+        elif event == EVT_ISR_ENTER:
+            name = EXCEPTION_NAMES.get(data, 'IRQ%d' % (data - 16))
+            tid = self.tid(('isr', data), 'ISR ' + name)
+            self.isr_stack.append(data)
+            self.add('B', name, tid, args={'interrupted': self.name(task, 'task')})
+        elif event == EVT_ISR_EXIT:
+            if data in self.isr_stack:
+                self.isr_stack.remove(data)
+                name = EXCEPTION_NAMES.get(data, 'IRQ%d' % (data - 16))
+                self.add('E', name, self.tid(('isr', data), 'ISR ' + name))
+
+    def finish(self):
+        # Close slices that are still open at the end of the trace
+        for task in list(self.running):
+            self.add('E', 'running', self.task_tid(task))
+        for isr in self.isr_stack:
+            name = EXCEPTION_NAMES.get(isr, 'IRQ%d' % (isr - 16))
+            self.add('E', name, self.tid(('isr', isr), 'ISR ' + name))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help='trace dump, or record stream with --raw')
+    parser.add_argument('-o', '--output', default='-', help='output JSON file (default: stdout)')
+    parser.add_argument('--raw', action='store_true', help='input is a stream of records without header')
+    parser.add_argument('--swo', action='store_true', help='input is a raw SWO capture of ITM packets')
+    parser.add_argument('--itm-port', type=int, default=1, help='RT_TRACE_ITM_PORT (default: 1)')
+    parser.add_argument('--cpu-hz', type=int, default=0, help='cycle counter frequency (default: from dump, or 168 MHz)')
+    parser.add_argument('--elf', help='elf file used to name tasks and objects, e.g. build/rtos-cm4.elf')
+    parser.add_argument('--nm', default='arm-none-eabi-nm', help='nm executable')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    if args.swo:
+        cpu_hz = args.cpu_hz
+        lost, records = parse_swo(data, args.itm_port)
+    else:
+        cpu_hz, lost, records = parse(data, args.raw, args.cpu_hz)
+    exporter = Exporter(cpu_hz or 168000000, read_symbols(args.elf, args.nm))
+    exporter.events.append({'ph': 'M', 'name': 'process_name', 'pid': 1, 'args': {'name': 'rtos-cm4'}})
+
+    for record in records:
+        exporter.record(*record)
+    exporter.finish()
+
+    trace = {'traceEvents': exporter.events, 'displayTimeUnit': 'ns',
+             'otherData': {'records': len(records), 'lost': lost}}
+
+    if args.output == '-':
+        json.dump(trace, sys.stdout, indent=1)
+    else:
+        with open(args.output, 'w') as f:
+            json.dump(trace, f, indent=1)
+
+    if lost:
+        print('Note: %d records were lost (overwritten)' % lost, file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()